@@ -1,12 +1,16 @@
 #include "dict.h"
 
+#include <algorithm>
+#include <bit>
 #include <fstream>
 #include <string>
 
 #include "absl/flags/flag.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "re2/re2.h"
+#include "src/shared/fingerprint.h"
 
 ABSL_FLAG(std::string, valid_file_path, "data/words_bongo.txt",
           "Input file containing all legal words for Bongo.");
@@ -51,6 +55,7 @@ Dict::Dict(const absl::flat_hash_set<std::string>& words,
   for (const std::string& word : words) words_[LetterCount(word)].insert(word);
   for (const std::string& word : common_words)
     common_words_[LetterCount(word)].insert(word);
+  BuildIndex();
 }
 
 // Accessors
@@ -67,6 +72,9 @@ bool Dict::IsCommonWord(absl::string_view word) const {
 
 absl::flat_hash_set<std::string> Dict::WordsMatchingParameters(
     const SearchParameters& params) const {
+  if (!params.letters_by_position.empty())
+    return WordsMatchingPositions(params);
+
   absl::flat_hash_set<std::string> matches;
 
   for (const auto& [letter_count, anagrams] : words_) {
@@ -88,4 +96,90 @@ absl::flat_hash_set<std::string> Dict::WordsMatchingParameters(
   return matches;
 }
 
-}  // namespace puzzmo::bongo
\ No newline at end of file
+// Index
+
+void Dict::BuildIndex() {
+  for (const auto& [letter_count, anagrams] : words_) {
+    for (const std::string& word : anagrams) {
+      if (word.size() >= words_by_length_.size())
+        words_by_length_.resize(word.size() + 1);
+      words_by_length_[word.size()].push_back(word);
+    }
+  }
+
+  index_.resize(words_by_length_.size());
+  for (int n = 0; n < words_by_length_.size(); ++n) {
+    std::vector<std::string>& words = words_by_length_[n];
+    std::sort(words.begin(), words.end());
+    const int blocks = (words.size() + 63) / 64;
+    index_[n].assign(n, std::vector<WordBitset>(26, WordBitset(blocks)));
+    for (int id = 0; id < words.size(); ++id) {
+      for (int i = 0; i < n; ++i) {
+        const char c = words[id][i];
+        if (c < 'a' || c > 'z') continue;
+        index_[n][i][c - 'a'][id / 64] |= uint64_t{1} << (id % 64);
+      }
+    }
+  }
+
+  std::string all_words;
+  for (const std::vector<std::string>& words : words_by_length_)
+    for (const std::string& word : words)
+      absl::StrAppend(&all_words, word, IsCommonWord(word) ? "*" : "", "\n");
+  version_ = Fingerprint(all_words);
+}
+
+absl::flat_hash_set<std::string> Dict::WordsMatchingPositions(
+    const SearchParameters& params) const {
+  absl::flat_hash_set<std::string> matches;
+  const int n = params.letters_by_position.size();
+  if (n < params.min_length || n > params.max_length) return matches;
+
+  // Only the words matching the pattern need their letters counted.
+  const WordBitset candidates =
+      WordIdsMatchingPattern(params.letters_by_position);
+  for (int b = 0; b < candidates.size(); ++b) {
+    for (uint64_t bits = candidates[b]; bits != 0; bits &= bits - 1) {
+      const std::string& word = WordWithId(n, 64 * b + std::countr_zero(bits));
+      const LetterCount letter_count(word);
+      if (!letter_count.contains(params.min_letters)) continue;
+      if (!params.max_letters.empty() &&
+          !params.max_letters.contains(letter_count))
+        continue;
+      if (!params.matching_regex.empty() &&
+          !RE2::FullMatch(word, params.matching_regex))
+        continue;
+      matches.insert(word);
+    }
+  }
+  return matches;
+}
+
+// Word IDs
+
+Dict::WordBitset Dict::WordIdsMatchingPattern(
+    const std::vector<std::string>& pattern) const {
+  const int n = pattern.size();
+  if (n >= words_by_length_.size()) return {};
+
+  // Intersect, over each restricted position, the union of the bitsets of the
+  // letters allowed there.
+  const std::vector<std::string>& words = words_by_length_[n];
+  WordBitset ids((words.size() + 63) / 64, ~uint64_t{0});
+  if (const int tail = words.size() % 64; tail != 0)
+    ids.back() = (uint64_t{1} << tail) - 1;
+  for (int i = 0; i < n; ++i) {
+    const absl::string_view allowed = pattern[i];
+    if (allowed.empty()) continue;
+    WordBitset position(ids.size());
+    for (char c : allowed) {
+      if (c < 'a' || c > 'z') continue;
+      const WordBitset& letter = index_[n][i][c - 'a'];
+      for (int b = 0; b < position.size(); ++b) position[b] |= letter[b];
+    }
+    for (int b = 0; b < ids.size(); ++b) ids[b] &= position[b];
+  }
+  return ids;
+}
+
+}  // namespace puzzmo::bongo
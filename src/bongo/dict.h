@@ -9,7 +9,10 @@
 #ifndef PUZZMO_BONGO_DICT_H_
 #define PUZZMO_BONGO_DICT_H_
 
+#include <climits>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
@@ -27,7 +30,10 @@ namespace puzzmo::bongo {
 // - `common_words_`, a set containing all words that Bongo counts as "common".
 //   Every word in `common_words_` is also in `words_`.
 //
-// The dictionary can also be searched via `WordsMatchingParameters()`.
+// The dictionary can also be searched via `WordsMatchingParameters()`. To make
+// line queries cheap, every word of a given length is also given an ID, and
+// for each (length, position, letter) a bitset over those IDs records which
+// words have that letter in that position.
 class Dict {
  public:
   //--------------
@@ -47,7 +53,9 @@ class Dict {
            words,
        const absl::flat_hash_map<LetterCount, absl::flat_hash_set<std::string>>&
            common_words)
-      : words_(words), common_words_(common_words) {}
+      : words_(words), common_words_(common_words) {
+    BuildIndex();
+  }
 
   //-----------
   // Accessors
@@ -62,6 +70,12 @@ class Dict {
   // Looks up the word directly in `common_words_`. Runs in O(1) time.
   bool IsCommonWord(absl::string_view word) const;
 
+  // Dict::version()
+  //
+  // Returns a fingerprint of every word and whether it is common. Two `Dict`s
+  // with the same version score every board the same way.
+  uint64_t version() const { return version_; }
+
   //--------
   // Search
 
@@ -75,6 +89,13 @@ class Dict {
     LetterCount min_letters;
     LetterCount max_letters;
     std::string matching_regex;
+
+    // If non-empty, only words of exactly this many letters are matched, and
+    // the letter at position `i` of the word must be one of the letters in
+    // `letters_by_position[i]`. An empty string places no restriction on that
+    // position. These queries are answered from the bitset index rather than
+    // by scanning the dictionary.
+    std::vector<std::string> letters_by_position;
   };
 
   // Dict::WordsMatchingParameters()
@@ -83,10 +104,57 @@ class Dict {
   absl::flat_hash_set<std::string> WordsMatchingParameters(
       const SearchParameters& params) const;
 
+  //-----------
+  // Word IDs
+
+  // A bitset over the IDs of the words of a single length.
+  using WordBitset = std::vector<uint64_t>;
+
+  // Dict::WordIdsMatchingPattern()
+  //
+  // Returns the IDs of the words with `pattern.size()` letters whose letter at
+  // position `i` is one of the letters in `pattern[i]`, as in
+  // `SearchParameters::letters_by_position`.
+  WordBitset WordIdsMatchingPattern(
+      const std::vector<std::string>& pattern) const;
+
+  // Dict::WordIdsWithLetter()
+  //
+  // Returns the IDs of the words of length `n` with the letter `c` at position
+  // `i`.
+  const WordBitset& WordIdsWithLetter(int n, int i, char c) const {
+    return index_[n][i][c - 'a'];
+  }
+
+  // Dict::WordWithId()
+  //
+  // Returns the word of length `n` with ID `id`.
+  const std::string& WordWithId(int n, int id) const {
+    return words_by_length_[n][id];
+  }
+
  private:
+  // Dict::BuildIndex()
+  //
+  // Populates `words_by_length_`, `index_` and `version_` from `words_`.
+  void BuildIndex();
+
+  // Dict::WordsMatchingPositions()
+  //
+  // Handles `WordsMatchingParameters()` when `letters_by_position` is set.
+  absl::flat_hash_set<std::string> WordsMatchingPositions(
+      const SearchParameters& params) const;
+
   absl::flat_hash_map<LetterCount, absl::flat_hash_set<std::string>> words_;
   absl::flat_hash_map<LetterCount, absl::flat_hash_set<std::string>>
       common_words_;
+
+  // `words_by_length_[n]` lists every word of length `n` in alphabetical
+  // order; a word's index in that list is its ID. Bit `id` of
+  // `index_[n][i][c - 'a']` is set if that word has letter `c` at position `i`.
+  std::vector<std::vector<std::string>> words_by_length_;
+  std::vector<std::vector<std::vector<WordBitset>>> index_;
+  uint64_t version_ = 0;
 };
 
 }  // namespace puzzmo::bongo
@@ -64,5 +64,53 @@ TEST(DictTest, GetMatchingWords) {
                    .contains("finds"));
 }
 
+TEST(DictTest, GetMatchingWordsByPosition) {
+  absl::flat_hash_set<std::string> valid_words = {"monkey", "panel", "vines",
+                                                  "flute", "finds", "fines"};
+  absl::flat_hash_set<std::string> common_words = {"panel", "flute", "finds"};
+  Dict dict(std::move(valid_words), std::move(common_words));
+
+  EXPECT_THAT(dict.WordsMatchingParameters(
+                  {.letters_by_position = {"", "", "", "", ""}}),
+              testing::UnorderedElementsAre("panel", "vines", "flute", "finds",
+                                            "fines"));
+  EXPECT_THAT(dict.WordsMatchingParameters(
+                  {.letters_by_position = {"fv", "i", "n", "", ""}}),
+              testing::UnorderedElementsAre("vines", "finds", "fines"));
+  EXPECT_THAT(dict.WordsMatchingParameters(
+                  {.letters_by_position = {"f", "i", "n", "de", "s"}}),
+              testing::UnorderedElementsAre("finds", "fines"));
+  EXPECT_THAT(dict.WordsMatchingParameters(
+                  {.max_letters = LetterCount("efinsz"),
+                   .letters_by_position = {"f", "", "", "", ""}}),
+              testing::UnorderedElementsAre("fines"));
+  EXPECT_THAT(dict.WordsMatchingParameters(
+                  {.min_letters = LetterCount("d"),
+                   .letters_by_position = {"f", "", "", "", ""}}),
+              testing::UnorderedElementsAre("finds"));
+  EXPECT_THAT(
+      dict.WordsMatchingParameters({.letters_by_position = {"", "", "", ""}}),
+      testing::IsEmpty());
+  EXPECT_THAT(dict.WordsMatchingParameters(
+                  {.max_length = 4,
+                   .letters_by_position = {"", "", "", "", ""}}),
+              testing::IsEmpty());
+}
+
+TEST(DictTest, WordIdsMatchingPattern) {
+  absl::flat_hash_set<std::string> valid_words = {"monkey", "panel", "vines",
+                                                  "flute", "finds", "fines"};
+  Dict dict(std::move(valid_words), {});
+
+  // IDs follow alphabetical order: finds, fines, flute, panel, vines.
+  EXPECT_THAT(dict.WordIdsMatchingPattern({"fv", "i", "", "", ""}),
+              testing::ElementsAre(0b10011));
+  EXPECT_EQ(dict.WordWithId(5, 4), "vines");
+  EXPECT_THAT(dict.WordIdsMatchingPattern({"p", "i", "", "", ""}),
+              testing::ElementsAre(0));
+  EXPECT_THAT(dict.WordIdsMatchingPattern({"", "", "", "", "", "", ""}),
+              testing::IsEmpty());
+}
+
 }  // namespace
 }  // namespace puzzmo::bongo
\ No newline at end of file
@@ -36,26 +36,36 @@ Gamestate::Gamestate(const std::vector<std::string> board,
                      absl::flat_hash_map<char, int> letter_values,
                      LetterCount unplaced_letters,
                      std::vector<std::string> letter_board)
-    : grid_(5, std::vector<Cell>(5)),
+    : cells_(),
       letters_(unplaced_letters),
       unplaced_letters_(unplaced_letters),
-      letter_values_(letter_values) {
+      letter_values_{},
+      valued_letters_(0),
+      bonus_line_(),
+      bonus_line_size_(0) {
   CHECK_EQ(board.size(), 5);
   CHECK_EQ(letter_board.size(), 5);
 
+  for (const auto &[c, value] : letter_values) {
+    CHECK(std::islower(c));
+    letter_values_[c - 'a'] = value;
+    valued_letters_ |= 1u << (c - 'a');
+  }
+
   for (int r = 0; r < 5; ++r) {
     CHECK_EQ(board[r].size(), 5);
     CHECK_EQ(letter_board[r].size(), 5);
 
     for (int c = 0; c < 5; ++c) {
-      Cell &cell = grid_[r][c];
+      Cell &cell = cells_[5 * r + c];
       cell.letter = letter_board[r][c];
       if (std::isalpha(cell.letter))
         (void)unplaced_letters_.RemoveLetter(cell.letter);
 
       switch (board[r][c]) {
         case kBonusCell:
-          bonus_line_.push_back({.row = r, .col = c});
+          CHECK_LT(bonus_line_size_, bonus_line_.size());
+          bonus_line_[bonus_line_size_++] = {.row = r, .col = c};
           break;
         case kDoubleMultiplier:
           cell.multiplier = 2;
@@ -72,18 +82,34 @@ Gamestate::Gamestate(const std::vector<std::string> board,
 
 // Accessors
 
+std::vector<std::vector<Cell>> Gamestate::grid() const {
+  std::vector<std::vector<Cell>> grid;
+  for (int r = 0; r < 5; ++r) {
+    absl::Span<const Cell> row = (*this)[r];
+    grid.push_back(std::vector<Cell>(row.begin(), row.end()));
+  }
+  return grid;
+}
+
+absl::flat_hash_map<char, int> Gamestate::letter_values() const {
+  absl::flat_hash_map<char, int> letter_values;
+  for (char c = 'a'; c <= 'z'; ++c)
+    if (valued_letters_ & (1u << (c - 'a'))) letter_values[c] = letter_value(c);
+  return letter_values;
+}
+
 std::vector<Point> Gamestate::MultiplierPoints() const {
   std::vector<Point> multiplier_points;
   for (int r = 0; r < 5; ++r) {
     for (int c = 0; c < 5; ++c) {
-      if (grid_[r][c].multiplier >= 2)
+      if (cells_[5 * r + c].multiplier >= 2)
         multiplier_points.push_back({.row = r, .col = c});
     }
   }
   std::sort(multiplier_points.begin(), multiplier_points.end(),
-            [*this](const Point &lhs, const Point &rhs) {
-              const int lhs_mult = grid_[lhs.row][lhs.col].multiplier;
-              const int rhs_mult = grid_[rhs.row][rhs.col].multiplier;
+            [this](const Point &lhs, const Point &rhs) {
+              const int lhs_mult = (*this)[lhs].multiplier;
+              const int rhs_mult = (*this)[rhs].multiplier;
               return lhs_mult != rhs_mult ? lhs_mult > rhs_mult
                      : lhs.row != rhs.row ? lhs.row < rhs.row
                                           : lhs.col < rhs.col;
@@ -95,7 +121,7 @@ std::vector<Point> Gamestate::DoublePoints() const {
   std::vector<Point> double_points;
   for (int r = 0; r < 5; ++r) {
     for (int c = 0; c < 5; ++c) {
-      if (grid_[r][c].multiplier == 2)
+      if (cells_[5 * r + c].multiplier == 2)
         double_points.push_back({.row = r, .col = c});
     }
   }
@@ -105,7 +131,7 @@ std::vector<Point> Gamestate::DoublePoints() const {
 Point Gamestate::TriplePoint() const {
   for (int r = 0; r < 5; ++r) {
     for (int c = 0; c < 5; ++c) {
-      if (grid_[r][c].multiplier == 3) return {.row = r, .col = c};
+      if (cells_[5 * r + c].multiplier == 3) return {.row = r, .col = c};
     }
   }
   return {-1, -1};  // Should never happen.
@@ -116,7 +142,7 @@ std::string Gamestate::NMostValuableLetters(int n) const {
 
   std::string letters = unplaced_letters_.CharsInOrder();
   std::sort(letters.begin(), letters.end(), [this](char l, char r) {
-    return letter_values_.at(l) > letter_values_.at(r);
+    return letter_value(l) > letter_value(r);
   });
   return letters.substr(0, n);
 }
@@ -143,9 +169,20 @@ std::string Gamestate::LineRegex(const std::vector<Point> &line) const {
   return rgx;
 }
 
+std::vector<std::string> Gamestate::LinePattern(
+    const std::vector<Point> &line) const {
+  const std::string unplaced = unplaced_letters_.UniqueLetters();
+  std::vector<std::string> pattern;
+  for (const Point &p : line) {
+    const char l = (*this)[p].letter;
+    pattern.push_back(std::isalpha(l) ? std::string(1, l) : unplaced);
+  }
+  return pattern;
+}
+
 std::string Gamestate::LineString(const std::vector<Point> &line) const {
   std::string s = "";
-  for (const Point &p : line) s.push_back(grid_[p.row][p.col].letter);
+  for (const Point &p : line) s.push_back((*this)[p].letter);
   return s;
 }
 
@@ -154,11 +191,11 @@ std::string Gamestate::LineString(const std::vector<Point> &line) const {
 absl::Status Gamestate::ClearCell(const Point &p) {
   if (!HasCell(p))
     return absl::InvalidArgumentError(absl::StrFormat(kNoCellAtPointError, p));
-  if (grid_[p.row][p.col].is_locked)
+  if ((*this)[p].is_locked)
     return absl::FailedPreconditionError(absl::StrFormat(kLockedCellError, p));
 
   // If a letter is already in the cell, add it to `unplaced_letters_`.
-  char letter_in_cell = grid_[p.row][p.col].letter;
+  char letter_in_cell = (*this)[p].letter;
   if (std::isalpha(letter_in_cell)) {
     if (absl::Status s = unplaced_letters_.AddLetter(letter_in_cell); !s.ok()) {
       LOG(ERROR) << s;
@@ -166,7 +203,7 @@ absl::Status Gamestate::ClearCell(const Point &p) {
     }
   }
 
-  grid_[p.row][p.col].letter = kEmptyCell;
+  (*this)[p].letter = kEmptyCell;
   return absl::OkStatus();
 }
 
@@ -181,7 +218,7 @@ absl::Status Gamestate::FillCell(const Point &p, char l) {
     return s;
   }
 
-  grid_[p.row][p.col].letter = l;
+  (*this)[p].letter = l;
   return absl::OkStatus();
 }
 
@@ -192,8 +229,8 @@ absl::Status Gamestate::ClearLine(const std::vector<Point> &line) {
           absl::StrFormat(kNoCellAtPointError, p));
 
     // If the cell isn't locked and contains a letter, clear it.
-    if (!grid_[p.row][p.col].is_locked &&
-        std::isalpha(grid_[p.row][p.col].letter)) {
+    if (!(*this)[p].is_locked &&
+        std::isalpha((*this)[p].letter)) {
       if (absl::Status s = ClearCell(p); !s.ok()) {
         LOG(ERROR) << s;
         return s;
@@ -213,7 +250,7 @@ absl::Status Gamestate::FillLine(const std::vector<Point> &line,
     const Point p = line[i];
     // If the letter in the cell already aligns with `word`, we don't call
     // `FillCell()`.
-    if (grid_[p.row][p.col].letter == word[i]) continue;
+    if ((*this)[p].letter == word[i]) continue;
     if (absl::Status s = FillCell(p, word[i]); !s.ok()) {
       LOG(ERROR) << s;
       return s;
@@ -225,7 +262,7 @@ absl::Status Gamestate::FillLine(const std::vector<Point> &line,
 absl::Status Gamestate::ClearBoard() {
   for (int r = 0; r < 5; ++r) {
     for (int c = 0; c < 5; ++c) {
-      if (grid_[r][c].is_locked) continue;
+      if (cells_[5 * r + c].is_locked) continue;
       if (absl::Status s = ClearCell({r, c}); !s.ok()) {
         LOG(ERROR) << s;
         return s;
@@ -238,15 +275,14 @@ absl::Status Gamestate::ClearBoard() {
 // Relational
 
 bool Gamestate::IsChildOf(const Gamestate &other) const {
-  if (letters() != other.letters() || letter_values_ != other.letter_values() ||
-      bonus_line_ != other.bonus_line())
+  if (letters() != other.letters() || letter_values_ != other.letter_values_ ||
+      valued_letters_ != other.valued_letters_ ||
+      bonus_line() != other.bonus_line())
     return false;
-  for (int r = 0; r < 5; ++r) {
-    for (int c = 0; c < 5; ++c) {
-      if (grid_[r][c].multiplier != other.grid()[r][c].multiplier) return false;
-      char l = other.grid()[r][c].letter;
-      if (std::isalpha(l) && grid_[r][c].letter != l) return false;
-    }
+  for (int i = 0; i < cells_.size(); ++i) {
+    if (cells_[i].multiplier != other.cells_[i].multiplier) return false;
+    char l = other.cells_[i].letter;
+    if (std::isalpha(l) && cells_[i].letter != l) return false;
   }
   return true;
 }
@@ -260,19 +296,19 @@ std::vector<std::vector<Point>> Gamestate::LinesToScore() const {
   lines.push_back(line(2));
   lines.push_back(line(3));
   lines.push_back(line(4));
-  lines.push_back(bonus_line_);
+  lines.push_back(bonus_line());
   return lines;
 }
 
 int Gamestate::UpperBoundOnScore() const {
   std::string tiles_in_value_order = NMostValuableLetters(25);
   int score = 0;
-  score += letter_values_.at(tiles_in_value_order[0]) * 3;
+  score += letter_value(tiles_in_value_order[0]) * 3;
   for (int i = 1; i < 8; ++i) {
-    score += letter_values_.at(tiles_in_value_order[i]) * 2;
+    score += letter_value(tiles_in_value_order[i]) * 2;
   }
   for (int i = 8; i < tiles_in_value_order.size(); ++i) {
-    score += letter_values_.at(tiles_in_value_order[i]);
+    score += letter_value(tiles_in_value_order[i]);
   }
   return std::ceil(1.3 * score);
 }
@@ -284,9 +320,10 @@ bool operator==(const Cell &lhs, const Cell &rhs) {
 }
 
 bool operator==(const Gamestate &lhs, const Gamestate &rhs) {
-  return lhs.grid() == rhs.grid() &&
-         lhs.unplaced_letters() == rhs.unplaced_letters() &&
-         lhs.letter_values() == rhs.letter_values() &&
+  return lhs.cells_ == rhs.cells_ &&
+         lhs.unplaced_letters_ == rhs.unplaced_letters_ &&
+         lhs.letter_values_ == rhs.letter_values_ &&
+         lhs.valued_letters_ == rhs.valued_letters_ &&
          lhs.bonus_line() == rhs.bonus_line();
 }
 
@@ -10,12 +10,16 @@
 #ifndef PUZZMO_BONGO_GAMESTATE_H_
 #define PUZZMO_BONGO_GAMESTATE_H_
 
+#include <array>
+#include <cstdint>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "src/shared/letter_count.h"
 #include "src/shared/point.h"
 
@@ -35,7 +39,12 @@ struct Cell {
   // TODO: remove locking, since it's no longer necessary.
   bool is_locked = false;
   char letter = kEmptyCell;
-  int multiplier = 1;
+  int8_t multiplier = 1;
+
+  template <typename H>
+  friend H AbslHashValue(H h, const Cell &cell) {
+    return H::combine(std::move(h), cell.letter, cell.multiplier);
+  }
 };
 
 bool operator==(const Cell &lhs, const Cell &rhs);
@@ -46,8 +55,11 @@ bool operator!=(const Cell &lhs, const Cell &rhs);
 // The `Gamestate` class represents the state of play in a Bongo game at any
 // given moment. Most of the information is defined within two data members: a
 // 5x5 matrix of `Cell` objects and a `LetterCount` of unplayed letters. It also
-// contains a vector of `Point` objects charting the location of the bonus line,
-// as well as a map of the values for each letter when scoring.
+// contains the `Point` objects charting the location of the bonus line, as well
+// as the values for each letter when scoring.
+//
+// All storage is fixed-size, so a `Gamestate` is trivially copyable and can be
+// copied or reset in the middle of a search without touching the heap.
 class Gamestate {
  public:
   //--------------
@@ -73,18 +85,23 @@ class Gamestate {
 
   // Gamestate::grid()
   //
-  // Provides access to the underlying matrix of `Cell`s.
-  std::vector<std::vector<Cell>> grid() const { return grid_; }
+  // Returns a copy of the underlying `Cell`s as a 5x5 matrix. Prefer
+  // `operator[]` in hot code, as this allocates.
+  std::vector<std::vector<Cell>> grid() const;
 
   // operator[]
   //
   // `Gamestate` has two separate overloaded subscript operators. If provided an
-  // int, it treats it as the index of a row and returns that row. If provided
-  // a `Point` instead, it returns the `Cell` at that row and column in `grid_`.
-  std::vector<Cell> &operator[](int row) { return grid_[row]; }
-  const std::vector<Cell> &operator[](int row) const { return grid_[row]; }
-  Cell &operator[](Point p) { return grid_[p.row][p.col]; }
-  const Cell &operator[](Point p) const { return grid_[p.row][p.col]; }
+  // int, it treats it as the index of a row and returns a view of that row. If
+  // provided a `Point` instead, it returns the `Cell` at that row and column.
+  absl::Span<Cell> operator[](int row) {
+    return absl::MakeSpan(&cells_[5 * row], 5);
+  }
+  absl::Span<const Cell> operator[](int row) const {
+    return absl::MakeConstSpan(&cells_[5 * row], 5);
+  }
+  Cell &operator[](Point p) { return cells_[5 * p.row + p.col]; }
+  const Cell &operator[](Point p) const { return cells_[5 * p.row + p.col]; }
 
   // Gamestate::MultiplierPoints()
   //
@@ -135,7 +152,10 @@ class Gamestate {
   // Gamestate::bonus_line()
   //
   // Returns a vector of points corresponding to the bonus line on the grid.
-  std::vector<Point> bonus_line() const { return bonus_line_; }
+  std::vector<Point> bonus_line() const {
+    return std::vector<Point>(bonus_line_.begin(),
+                              bonus_line_.begin() + bonus_line_size_);
+  }
 
   // Gamestate::LineRegex()
   //
@@ -144,6 +164,13 @@ class Gamestate {
   // matching any character in `unplaced_letters_`.
   std::string LineRegex(const std::vector<Point> &line) const;
 
+  // Gamestate::LinePattern()
+  //
+  // Returns, for each `Point` in `line`, the letters that could occupy its
+  // cell: the letter already placed there, if any, or else every letter in
+  // `unplaced_letters_`. Suitable for `Dict::SearchParameters`.
+  std::vector<std::string> LinePattern(const std::vector<Point> &line) const;
+
   // Gamestate::LineString()
   //
   // Returns a string comprised of the letter in each `Cell` pointed to by the
@@ -152,10 +179,15 @@ class Gamestate {
 
   // Gamestate::letter_values()
   //
-  // Provides access to a map from chars to their associated tile score.
-  absl::flat_hash_map<char, int> letter_values() const {
-    return letter_values_;
-  }
+  // Returns a map from chars to their associated tile score. Prefer
+  // `letter_value()` in hot code, as this allocates.
+  absl::flat_hash_map<char, int> letter_values() const;
+
+  // Gamestate::letter_value()
+  //
+  // Returns the tile score of lowercase letter `c`, or 0 if it was given no
+  // value. If `c` is not a lowercase letter, exhibits undefined behavior.
+  int letter_value(char c) const { return letter_values_[c - 'a']; }
 
   //----------
   // Mutators
@@ -211,36 +243,46 @@ class Gamestate {
   int UpperBoundOnScore() const;
 
  private:
-  std::vector<std::vector<Cell>> grid_;
+  friend bool operator==(const Gamestate &lhs, const Gamestate &rhs);
+
+  // The cells of the grid in row-major order.
+  std::array<Cell, 25> cells_;
   LetterCount letters_;
   LetterCount unplaced_letters_;
-  absl::flat_hash_map<char, int> letter_values_;
-  std::vector<Point> bonus_line_;
+
+  // The value of each letter, indexed by `c - 'a'`. Bit `c - 'a'` of
+  // `valued_letters_` is set for each letter that was given a value, so that
+  // `letter_values()` can reproduce the map it was constructed from.
+  std::array<int, 26> letter_values_;
+  uint32_t valued_letters_;
+
+  // Only the first `bonus_line_size_` points are meaningful.
+  std::array<Point, 5> bonus_line_;
+  int bonus_line_size_;
 
   //------------------
   // Abseil functions
 
   template <typename H>
   friend H AbslHashValue(H h, const Gamestate &bgs) {
-    return H::combine(std::move(h), bgs.grid_, bgs.unplaced_letters_,
-                      bgs.letter_values_, bgs.bonus_line_);
+    return H::combine(std::move(h), bgs.cells_, bgs.unplaced_letters_,
+                      bgs.letter_values_, bgs.bonus_line());
   }
 
   template <typename Sink>
   friend void AbslStringify(Sink &sink, const Gamestate &bgs) {
-    sink.Append(absl::StrJoin(
-        bgs.grid_, "\n", [](std::string *out, const std::vector<Cell> &row) {
-          absl::StrAppend(out, "[",
-                          absl::StrJoin(row, "",
-                                        [](std::string *out, const Cell &cell) {
-                                          absl::StrAppend(
-                                              out, std::string(1, cell.letter));
-                                        }),
-                          "]");
-        }));
+    std::vector<std::string> rows;
+    for (int r = 0; r < 5; ++r) {
+      std::string row = "[";
+      for (const Cell &cell : bgs[r]) row.push_back(cell.letter);
+      rows.push_back(absl::StrCat(row, "]"));
+    }
+    sink.Append(absl::StrJoin(rows, "\n"));
   }
 };
 
+static_assert(std::is_trivially_copyable_v<Gamestate>);
+
 bool operator==(const Gamestate &lhs, const Gamestate &rhs);
 bool operator!=(const Gamestate &lhs, const Gamestate &rhs);
 
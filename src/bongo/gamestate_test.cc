@@ -28,6 +28,21 @@ TEST(GameStateTest, Constructor) {
   EXPECT_EQ(bgs.unplaced_letters().CharsInOrder(), "aaaabbbcdefgh");
 }
 
+TEST(GameStateTest, CopiesByValue) {
+  Gamestate bgs(kDummyBoard, kLetterValues, LetterCount("abcd"));
+  Gamestate copy = bgs;
+  ASSERT_THAT(copy.FillCell({0, 0}, 'a'), IsOk());
+  EXPECT_EQ(copy[0][0].letter, 'a');
+  EXPECT_EQ(bgs[0][0].letter, kEmptyCell);
+  EXPECT_NE(copy, bgs);
+
+  ASSERT_THAT(copy.ClearCell({0, 0}), IsOk());
+  EXPECT_EQ(copy, bgs);
+  EXPECT_EQ(copy.letter_value('d'), 4);
+  EXPECT_EQ(copy.bonus_line(), bgs.bonus_line());
+  EXPECT_EQ(copy[2][4].multiplier, 3);
+}
+
 TEST(GameStateTest, UpperBoundOnScore) {
   Gamestate bgs(kDummyBoard, kLetterValues,
                 LetterCount("abcdefghijklmnopqrstuvwxy"));
@@ -205,6 +220,16 @@ TEST(GamestateTest, RegexForLine) {
   EXPECT_EQ(bgs.LineRegex(bgs.bonus_line()), "ag[jms][jms]");
 }
 
+TEST(GamestateTest, PatternForLine) {
+  Gamestate bgs(kDummyBoard, kLetterValues,
+                LetterCount("abcdefghipqrtjsmmmmmmmmmm"),
+                {"abcde", "fghi_", "_____", "pqr_t", "_____"});
+  EXPECT_THAT(bgs.LinePattern(bgs.line(1)),
+              testing::ElementsAre("f", "g", "h", "i", "jms"));
+  EXPECT_THAT(bgs.LinePattern(bgs.bonus_line()),
+              testing::ElementsAre("a", "g", "jms", "jms"));
+}
+
 TEST(GamestateTest, AllOrNumLetters) {
   const LetterCount all_letters("aaaabbbcdefgh");
   Gamestate bgs(kDummyBoard, kLetterValues, all_letters);
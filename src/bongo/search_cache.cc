@@ -0,0 +1,122 @@
+#include "search_cache.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+#include "src/shared/fingerprint.h"
+
+namespace puzzmo::bongo {
+namespace {
+
+constexpr absl::string_view kBadKeyError =
+    "Cache key \"%s\" contains a tab or newline.";
+constexpr absl::string_view kFileError = "Error: Could not open %s.";
+constexpr absl::string_view kSkippedRecords =
+    "Skipped %d damaged records in %s.";
+constexpr absl::string_view kWriteError = "Error: Could not write to %s.";
+
+// Returns a record's line in the cache file, minus the trailing newline.
+std::string RecordLine(absl::string_view key,
+                       const SearchCache::Record &record) {
+  const std::string body = absl::StrCat(key, "\t", record.bound, "\t",
+                                        record.exact ? 1 : 0, "\t",
+                                        record.board);
+  return absl::StrCat(body, "\t", absl::Hex(Fingerprint(body)));
+}
+
+// Parses a line written by `RecordLine()`. Returns `false` if the line is
+// malformed or fails its checksum.
+bool ParseRecordLine(absl::string_view line, std::string &key,
+                     SearchCache::Record &record) {
+  const size_t last_tab = line.rfind('\t');
+  if (last_tab == absl::string_view::npos) return false;
+  const absl::string_view body = line.substr(0, last_tab);
+  uint64_t checksum;
+  if (!absl::SimpleHexAtoi(line.substr(last_tab + 1), &checksum) ||
+      checksum != Fingerprint(body))
+    return false;
+
+  std::vector<absl::string_view> fields = absl::StrSplit(body, '\t');
+  if (fields.size() != 4) return false;
+  int exact;
+  if (!absl::SimpleAtoi(fields[1], &record.bound) ||
+      !absl::SimpleAtoi(fields[2], &exact))
+    return false;
+  key = std::string(fields[0]);
+  record.exact = exact;
+  record.board = std::string(fields[3]);
+  return true;
+}
+
+}  // namespace
+
+// Constructors
+
+absl::StatusOr<std::unique_ptr<SearchCache>> SearchCache::Open(
+    const std::string &path) {
+  std::unique_ptr<SearchCache> cache(new SearchCache(path));
+  absl::MutexLock lock(&cache->mu_);
+
+  // Load what is already there.
+  bool ends_in_newline = true;
+  if (std::ifstream file(path); file.is_open()) {
+    std::string line;
+    int skipped = 0;
+    while (std::getline(file, line)) {
+      ends_in_newline = !file.eof();
+      std::string key;
+      Record record;
+      if (ParseRecordLine(line, key, record))
+        cache->records_[key] = std::move(record);
+      else
+        ++skipped;
+    }
+    if (skipped > 0)
+      LOG(WARNING) << absl::StrFormat(kSkippedRecords, skipped, path);
+  }
+
+  cache->file_.open(path, std::ios::app);
+  if (!cache->file_.is_open())
+    return absl::NotFoundError(absl::StrFormat(kFileError, path));
+  // Make sure new records don't get appended to a torn one.
+  if (!ends_in_newline) cache->file_ << '\n';
+  return cache;
+}
+
+// Accessors
+
+std::optional<SearchCache::Record> SearchCache::Lookup(
+    absl::string_view key) const {
+  absl::MutexLock lock(&mu_);
+  auto it = records_.find(key);
+  if (it == records_.end()) return std::nullopt;
+  return it->second;
+}
+
+int SearchCache::size() const {
+  absl::MutexLock lock(&mu_);
+  return records_.size();
+}
+
+// Mutators
+
+absl::Status SearchCache::Insert(absl::string_view key, const Record &record) {
+  if (key.find_first_of("\t\n") != absl::string_view::npos)
+    return absl::InvalidArgumentError(absl::StrFormat(kBadKeyError, key));
+
+  absl::MutexLock lock(&mu_);
+  records_[key] = record;
+  file_ << RecordLine(key, record) << '\n';
+  file_.flush();
+  if (!file_.good())
+    return absl::DataLossError(absl::StrFormat(kWriteError, path_));
+  return absl::OkStatus();
+}
+
+}  // namespace puzzmo::bongo
@@ -0,0 +1,92 @@
+// -----------------------------------------------------------------------------
+// File: search_cache.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines an on-disk cache of Bongo search results, so that
+// branches explored in one run of the solver need not be explored again in the
+// next, e.g. when re-running with broader parameters.
+
+#ifndef PUZZMO_BONGO_SEARCH_CACHE_H_
+#define PUZZMO_BONGO_SEARCH_CACHE_H_
+
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace puzzmo::bongo {
+
+// bongo::SearchCache
+//
+// A `SearchCache` maps keys, which identify a branch of a search, to what was
+// learned by exploring that branch. The cache is backed by an append-only file
+// with one checksummed record per line. Records are appended and flushed as
+// they are inserted. If a run is interrupted mid-write, the torn record fails
+// its checksum and is skipped the next time the file is opened. If a key is
+// inserted more than once, the last record wins.
+//
+// All methods are thread-safe.
+class SearchCache {
+ public:
+  // bongo::SearchCache::Record
+  //
+  // No board in the branch scores more than `bound`. If `exact` is true, then
+  // `board` scores exactly `bound`, and is the first such board in search
+  // order. `board` holds the 25 cells of the grid in row-major order.
+  struct Record {
+    int bound = 0;
+    bool exact = false;
+    std::string board;
+  };
+
+  //--------------
+  // Constructors
+
+  // SearchCache::Open()
+  //
+  // Loads every intact record in the file at `path`, creating the file if it
+  // does not yet exist, and opens it for appending.
+  static absl::StatusOr<std::unique_ptr<SearchCache>> Open(
+      const std::string &path);
+
+  //-----------
+  // Accessors
+
+  // SearchCache::Lookup()
+  //
+  // Returns the record for `key`, if there is one.
+  std::optional<Record> Lookup(absl::string_view key) const;
+
+  // SearchCache::size()
+  //
+  // Returns the number of keys with records.
+  int size() const;
+
+  //----------
+  // Mutators
+
+  // SearchCache::Insert()
+  //
+  // Records `record` under `key`, both in memory and on disk. Keys must not
+  // contain tabs or newlines.
+  absl::Status Insert(absl::string_view key, const Record &record);
+
+ private:
+  explicit SearchCache(const std::string &path) : path_(path) {}
+
+  const std::string path_;
+  mutable absl::Mutex mu_;
+  absl::flat_hash_map<std::string, Record> records_ ABSL_GUARDED_BY(mu_);
+  std::ofstream file_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace puzzmo::bongo
+
+#endif
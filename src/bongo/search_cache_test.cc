@@ -0,0 +1,84 @@
+#include "search_cache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "absl/status/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace puzzmo::bongo {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::StatusIs;
+
+std::string TempPath(absl::string_view name) {
+  std::string path = testing::TempDir() + std::string(name);
+  std::remove(path.c_str());
+  return path;
+}
+
+TEST(SearchCacheTest, PersistsBetweenRuns) {
+  const std::string path = TempPath("persists.cache");
+  {
+    absl::StatusOr<std::unique_ptr<SearchCache>> cache =
+        SearchCache::Open(path);
+    ASSERT_THAT(cache, IsOk());
+    EXPECT_EQ((*cache)->Lookup("a"), std::nullopt);
+    ASSERT_THAT((*cache)->Insert("a", {.bound = 10}), IsOk());
+    ASSERT_THAT((*cache)->Insert("b", {.bound = 5}), IsOk());
+    ASSERT_THAT(
+        (*cache)->Insert("a", {.bound = 7, .exact = true, .board = "abc"}),
+        IsOk());
+  }
+
+  absl::StatusOr<std::unique_ptr<SearchCache>> cache = SearchCache::Open(path);
+  ASSERT_THAT(cache, IsOk());
+  EXPECT_EQ((*cache)->size(), 2);
+  std::optional<SearchCache::Record> a = (*cache)->Lookup("a");
+  ASSERT_TRUE(a.has_value());
+  EXPECT_EQ(a->bound, 7);
+  EXPECT_TRUE(a->exact);
+  EXPECT_EQ(a->board, "abc");
+  EXPECT_EQ((*cache)->Lookup("b")->bound, 5);
+}
+
+TEST(SearchCacheTest, SkipsTornRecords) {
+  const std::string path = TempPath("torn.cache");
+  {
+    absl::StatusOr<std::unique_ptr<SearchCache>> cache =
+        SearchCache::Open(path);
+    ASSERT_THAT(cache, IsOk());
+    ASSERT_THAT((*cache)->Insert("a", {.bound = 10}), IsOk());
+  }
+  // Simulate a crash partway through writing a record.
+  std::ofstream(path, std::ios::app) << "b\t12\t0\t";
+
+  {
+    absl::StatusOr<std::unique_ptr<SearchCache>> cache =
+        SearchCache::Open(path);
+    ASSERT_THAT(cache, IsOk());
+    EXPECT_EQ((*cache)->size(), 1);
+    EXPECT_EQ((*cache)->Lookup("b"), std::nullopt);
+    ASSERT_THAT((*cache)->Insert("c", {.bound = 3}), IsOk());
+  }
+
+  absl::StatusOr<std::unique_ptr<SearchCache>> cache = SearchCache::Open(path);
+  ASSERT_THAT(cache, IsOk());
+  EXPECT_EQ((*cache)->size(), 2);
+  EXPECT_EQ((*cache)->Lookup("c")->bound, 3);
+}
+
+TEST(SearchCacheTest, RejectsBadKeys) {
+  absl::StatusOr<std::unique_ptr<SearchCache>> cache =
+      SearchCache::Open(TempPath("bad_keys.cache"));
+  ASSERT_THAT(cache, IsOk());
+  EXPECT_THAT((*cache)->Insert("a\tb", {}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace puzzmo::bongo
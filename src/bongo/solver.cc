@@ -1,12 +1,26 @@
 #include "solver.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <climits>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <queue>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/log.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "src/shared/fingerprint.h"
+#include "src/shared/parallel.h"
 
 namespace puzzmo::bongo {
 namespace {
@@ -14,6 +28,15 @@ namespace {
 constexpr absl::string_view kVerboseLoop =
     "%sBeginning loop %d/%d with %s \"%s\".";
 
+constexpr absl::string_view kCachedBoardError =
+    "Cached board \"%s\" does not fit the starting board.";
+constexpr absl::string_view kNoSolutionError =
+    "No solution found, even considering every tile.";
+constexpr absl::string_view kVerboseWidening =
+    "Best score so far is %d. Widening the search.";
+constexpr absl::string_view kVerboseParallel =
+    "Searching %d branches on %d threads.";
+
 // How to fill the second "%s" in `kVerboseLoop`.
 std::string VerboseLoopText(const Technique &t) {
   switch (t) {
@@ -49,6 +72,68 @@ std::string LongestAlphaSubstring(absl::string_view s) {
   return std::string(s.substr(best_start, best_len));
 }
 
+// Raises `a` to `value` if it is lower, returning whether it was.
+bool RaiseTo(std::atomic<int> &a, int value) {
+  int old = a;
+  while (value > old && !a.compare_exchange_weak(old, value)) {
+  }
+  return value > old;
+}
+
+// Describes the techniques that a task has left to apply, for a cache key.
+std::string RemainingTechniquesKey(const Solver::Parameters &params) {
+  std::string key;
+  for (int i = params.parallel_depth; i < params.techniques.size(); ++i) {
+    switch (params.techniques[i]) {
+      case Technique::kFillMostRestrictedRow:
+        absl::StrAppend(&key, "r");
+        break;
+      case Technique::kFillBonusWordCells:
+        absl::StrAppend(&key, "b", params.num_tiles_for_bonus_words);
+        break;
+      case Technique::kFillMultiplierCells:
+        absl::StrAppend(&key, "m", params.num_tiles_for_mult_cells);
+        break;
+    }
+  }
+  return key;
+}
+
+// Calls `visit` with `drawn` extended by every way to draw `sizes[g]` more
+// letters from `pool` for each group `g` from `k` on. Each group's letters are
+// drawn in alphabetical order, starting at `from` for group `k`, so that every
+// draw is visited exactly once.
+void DrawSortedLetters(std::vector<int> &sizes, int k, char from,
+                       LetterCount &pool, std::string &drawn,
+                       absl::FunctionRef<void(absl::string_view)> visit) {
+  if (k == sizes.size()) {
+    visit(drawn);
+    return;
+  }
+  if (sizes[k] == 0) {
+    DrawSortedLetters(sizes, k + 1, 'a', pool, drawn, visit);
+    return;
+  }
+  for (char c = from; c <= 'z'; ++c) {
+    if (!pool.contains(c)) continue;
+    const absl::string_view letter(&c, 1);
+    pool -= letter;
+    drawn.push_back(c);
+    --sizes[k];
+    DrawSortedLetters(sizes, k, c, pool, drawn, visit);
+    ++sizes[k];
+    drawn.pop_back();
+    pool += letter;
+  }
+}
+
+// Formats a vector of points for a cache key.
+std::string PointsString(const std::vector<Point> &points) {
+  return absl::StrJoin(points, ",", [](std::string *out, const Point &p) {
+    absl::StrAppend(out, absl::StrFormat("%v", p));
+  });
+}
+
 }  // namespace
 
 /** * * * * * * *
@@ -56,14 +141,21 @@ std::string LongestAlphaSubstring(absl::string_view s) {
  * * * * * * * **/
 
 Solver::Solver(const Dict &dict, const Gamestate &state, Parameters params)
-    : dict_(dict),
+    : dict_(std::make_shared<const Dict>(dict)),
       lines_(state.LinesToScore()),
       bonus_line_(state.bonus_line()),
       multiplier_points_(state.MultiplierPoints()),
       starting_state_(state),
       best_state_(state),
       state_(state),
-      params_(params) {}
+      params_(params),
+      lines_through_cell_(),
+      scored_lines_(lines_.size()) {
+  for (int i = 0; i < lines_.size(); ++i)
+    for (const Point &p : lines_[i])
+      lines_through_cell_[5 * p.row + p.col] |= 1 << i;
+  RebuildLineIds();
+}
 
 /** * * * * *
  * Mutators *
@@ -71,74 +163,430 @@ Solver::Solver(const Dict &dict, const Gamestate &state, Parameters params)
 
 void Solver::reset() {
   state_ = starting_state_;
-  locks_.clear();
+  reservations_.clear();
+  steps_.clear();
+  InvalidateLines(~0u);
+  RebuildLineIds();
 }
 
 absl::StatusOr<Gamestate> Solver::Solve() {
-  if (absl::Status s = RecursiveHelper(0); !s.ok()) {
-    LOG(ERROR) << s;
-    return s;
-  }
-  // Loop again if nothing found.
-  if (best_score_ == 0) {
-    ++params_.num_tiles_for_bonus_words;
-    ++params_.num_tiles_for_mult_cells;
-    LOG(INFO) << "No solutions found. Trying again with a broader search.";
-    return Solve();
+  previous_params_.reset();
+  for (int round = 0;; ++round) {
+    const bool by_task = params_.num_threads > 1 || cache_ != nullptr;
+    const bool needs_new_tile = previous_params_.has_value();
+    absl::Status s;
+    if (params_.best_first)
+      s = BestFirstHelper(needs_new_tile);
+    else if (by_task)
+      s = TaskHelper();
+    else
+      s = RecursiveHelper(0, needs_new_tile);
+    if (!s.ok()) {
+      LOG(ERROR) << s;
+      return s;
+    }
+    if (best_score_ > 0 && round >= params_.widening_rounds) break;
+
+    // Loop again, only searching boards that use a newly admitted tile.
+    if (!Widen()) {
+      if (best_score_ > 0) break;
+      return absl::NotFoundError(kNoSolutionError);
+    }
+    if (best_score_ == 0)
+      LOG(INFO) << "No solutions found. Trying again with a broader search.";
+    else
+      LOG(INFO) << absl::StrFormat(kVerboseWidening, best_score_);
   }
   return best_state_;
 }
 
-absl::Status Solver::RecursiveHelper(int i) {
+absl::Status Solver::RecursiveHelper(int i, bool needs_new_tile) {
   // Check for success/failure.
   if (IsComplete()) {
     UpdateBestState();
     return absl::OkStatus();
   }
 
-  // Get the technique to use.
-  Technique t = (i < params_.techniques.size())
-                    ? params_.techniques[i]
-                    : Technique::kFillMostRestrictedRow;
-
   // Get the cells targeted by the technique and the options for them.
-  std::vector<Point> cells;
-  absl::flat_hash_set<std::string> options;
-  switch (t) {
-    case Technique::kFillMostRestrictedRow:
-      cells = state_.line(MostRestrictedWordlessRow());
-      options = OptionsForLine(cells);
+  const Branches branches = BranchesFor(i, needs_new_tile);
+
+  int loop = 0;
+  for (int j = 0; j < branches.options.size(); ++j) {
+    const absl::string_view letters = branches.options[j];
+    // Boards without a newly admitted tile were searched in earlier rounds.
+    const bool still_needs_new_tile = needs_new_tile && !branches.is_new[j];
+    if (still_needs_new_tile && i >= LastWidenedTechnique()) continue;
+
+    if (i < 3)
+      LOG(INFO) << absl::StrFormat(kVerboseLoop, std::string(i + 1, ' '),
+                                   ++loop, branches.options.size(),
+                                   VerboseLoopText(branches.technique),
+                                   letters);
+
+    // Place the letters in the cells.
+    if (absl::Status s =
+            ApplyTechnique(branches.technique, branches.cells, letters);
+        !s.ok()) {
+      LOG(ERROR) << s;
+      return s;
+    }
+    // Recurse, unless nothing down this branch can beat the best board, or
+    // nothing down it can be completed at all.
+    if (CanBeatBestScore() && IsFeasible()) {
+      if (absl::Status s = RecursiveHelper(i + 1, still_needs_new_tile);
+          !s.ok()) {
+        LOG(ERROR) << s;
+        return s;
+      }
+    }
+    // Undo the placement.
+    if (absl::Status s = ClearCells(); !s.ok()) {
+      LOG(ERROR) << s;
+      return s;
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status Solver::BestFirstHelper(bool needs_new_tile) {
+  auto is_worse = [](const Node &lhs, const Node &rhs) {
+    return std::tie(lhs.bound, lhs.depth, rhs.order) <
+           std::tie(rhs.bound, rhs.depth, lhs.order);
+  };
+  std::priority_queue<Node, std::vector<Node>, decltype(is_worse)> queue(
+      is_worse);
+  // Keyed on whole boards rather than their hashes, so two different boards
+  // can never be mistaken for one another.
+  absl::flat_hash_set<
+      std::tuple<int, bool, Gamestate, std::vector<Reservation>>>
+      queued;
+  int64_t order = 0;
+
+  const Gamestate root = state_;
+  const std::vector<Reservation> root_reservations = reservations_;
+  if (IsComplete()) UpdateBestState();
+  if (!IsComplete() && CanBeatBestScore())
+    queue.push({.bound = UpperBound(),
+                .depth = 0,
+                .needs_new_tile = needs_new_tile,
+                .order = order++,
+                .state = state_,
+                .reservations = reservations_});
+
+  // Every queued board was bounded when it was queued, and the best score only
+  // grows, so once the top board cannot beat it, nothing left can.
+  while (!queue.empty() && queue.top().bound > best_score_) {
+    const Node node = queue.top();
+    queue.pop();
+    state_ = node.state;
+    reservations_ = node.reservations;
+    InvalidateLines(~0u);
+    RebuildLineIds();
+
+    const Branches branches = BranchesFor(node.depth, node.needs_new_tile);
+    for (int j = 0; j < branches.options.size(); ++j) {
+      const absl::string_view letters = branches.options[j];
+      const bool still_needs_new_tile =
+          node.needs_new_tile && !branches.is_new[j];
+      if (still_needs_new_tile && node.depth >= LastWidenedTechnique())
+        continue;
+
+      if (absl::Status s =
+              ApplyTechnique(branches.technique, branches.cells, letters);
+          !s.ok()) {
+        LOG(ERROR) << s;
+        return s;
+      }
+      if (IsComplete()) {
+        UpdateBestState();
+      } else if (!CanBeatBestScore() || !IsFeasible()) {
+        // Nothing down this branch can beat the best board.
+      } else if (queued.size() < params_.max_queued_states) {
+        // Boards reached along different paths are only queued once.
+        if (queued
+                .emplace(node.depth + 1, still_needs_new_tile, state_,
+                         reservations_)
+                .second)
+          queue.push({.bound = UpperBound(),
+                      .depth = node.depth + 1,
+                      .needs_new_tile = still_needs_new_tile,
+                      .order = order++,
+                      .state = state_,
+                      .reservations = reservations_});
+      } else if (absl::Status s =
+                     RecursiveHelper(node.depth + 1, still_needs_new_tile);
+                 !s.ok()) {
+        LOG(ERROR) << s;
+        return s;
+      }
+      if (absl::Status s = ClearCells(); !s.ok()) {
+        LOG(ERROR) << s;
+        return s;
+      }
+    }
+  }
+
+  state_ = root;
+  reservations_ = root_reservations;
+  InvalidateLines(~0u);
+  RebuildLineIds();
+  return absl::OkStatus();
+}
+
+int Solver::LastWidenedTechnique() const {
+  for (int i = params_.techniques.size() - 1; i >= 0; --i)
+    if (params_.techniques[i] != Technique::kFillMostRestrictedRow) return i;
+  return -1;
+}
+
+bool Solver::Widen() {
+  const int tiles = state_.unplaced_letters().size();
+  if (LastWidenedTechnique() < 0 ||
+      (params_.num_tiles_for_bonus_words >= tiles &&
+       params_.num_tiles_for_mult_cells >= tiles))
+    return false;
+  previous_params_ = params_;
+  ++params_.num_tiles_for_bonus_words;
+  ++params_.num_tiles_for_mult_cells;
+  return true;
+}
+
+Technique Solver::TechniqueAt(int i) const {
+  return (i < params_.techniques.size()) ? params_.techniques[i]
+                                         : Technique::kFillMostRestrictedRow;
+}
+
+Solver::Branches Solver::BranchesFor(int i, bool needs_new_tile) const {
+  Branches branches = {.technique = TechniqueAt(i)};
+
+  // Estimate each option by the value its letters would add to the board.
+  std::vector<std::pair<int, std::string>> estimated;
+  auto estimate = [&](absl::string_view letters) {
+    int estimate = 0;
+    for (int j = 0; j < letters.size(); ++j) {
+      const Point &p = branches.cells[j];
+      const int weight = state_[p].multiplier *
+                         (absl::c_linear_search(bonus_line_, p) ? 2 : 1);
+      estimate += state_.letter_value(letters[j]) * weight;
+    }
+    estimated.push_back({-estimate, std::string(letters)});
+  };
+  switch (branches.technique) {
+    case Technique::kFillMostRestrictedRow: {
+      // If every row has a word, the bonus line must not, and never will.
+      const int row = MostRestrictedWordlessRow();
+      if (!GetWord(row).empty()) break;
+      branches.cells = state_.line(row);
+      for (const std::string &letters : OptionsForLine(branches.cells))
+        estimate(letters);
       break;
+    }
 
     case Technique::kFillBonusWordCells:
-      cells = bonus_line_;
-      options = OptionsForBonusWord();
+      branches.cells = bonus_line_;
+      for (const std::string &letters :
+           OptionsForBonusWord(params_.num_tiles_for_bonus_words))
+        estimate(letters);
       break;
 
     case Technique::kFillMultiplierCells:
-      cells = RemainingMultiplierCells();
-      options = OptionsForMultiplierTiles();
+      branches.cells = RemainingMultiplierCells();
+      OptionsForMultiplierTiles(params_.num_tiles_for_mult_cells, estimate);
       break;
   }
+  std::sort(estimated.begin(), estimated.end());
+  for (auto &[estimate, letters] : estimated)
+    branches.options.push_back(std::move(letters));
 
-  int loop = 0;
-  for (const absl::string_view letters : options) {
-    if (i < 3)
-      LOG(INFO) << absl::StrFormat(kVerboseLoop, std::string(i + 1, ' '),
-                                   ++loop, options.size(), VerboseLoopText(t),
-                                   letters);
+  // Mark the options that the previous parameters would not have offered. Rows
+  // can use any tile, so their options are never new.
+  branches.is_new.assign(branches.options.size(), false);
+  if (!needs_new_tile) return branches;
+  switch (branches.technique) {
+    case Technique::kFillMostRestrictedRow:
+      break;
 
-    // Place the letters in the cells.
-    if (absl::Status s = FillCells(cells, letters); !s.ok()) {
+    case Technique::kFillBonusWordCells: {
+      const absl::flat_hash_set<std::string> old_options =
+          OptionsForBonusWord(previous_params_->num_tiles_for_bonus_words);
+      for (int j = 0; j < branches.options.size(); ++j)
+        branches.is_new[j] = !old_options.contains(branches.options[j]);
+      break;
+    }
+
+    case Technique::kFillMultiplierCells: {
+      // Every draw from the old tiles was offered before.
+      const LetterCount old_tiles(
+          MostValuableFreeLetters(previous_params_->num_tiles_for_mult_cells));
+      for (int j = 0; j < branches.options.size(); ++j)
+        branches.is_new[j] = !old_tiles.contains(branches.options[j]);
+      break;
+    }
+  }
+  return branches;
+}
+
+absl::Status Solver::TaskHelper() {
+  std::vector<Fill> prefix;
+  std::vector<Task> tasks;
+  if (absl::Status s =
+          CollectTasks(0, previous_params_.has_value(), prefix, tasks);
+      !s.ok()) {
+    LOG(ERROR) << s;
+    return s;
+  }
+  LOG(INFO) << absl::StrFormat(kVerboseParallel, tasks.size(),
+                               params_.num_threads);
+
+  // Each worker gets its own copy of the solver, and so of the gamestate.
+  std::atomic<int> shared_best_score = best_score_;
+  std::vector<Solver> workers(std::min<int>(params_.num_threads, tasks.size()),
+                              *this);
+  for (Solver &worker : workers) worker.shared_best_score_ = &shared_best_score;
+
+  std::vector<absl::Status> statuses(tasks.size());
+  std::vector<int> scores(tasks.size());
+  std::vector<Gamestate> states(tasks.size(), state_);
+  ParallelFor(tasks.size(), workers.size(), [&](int w, int task) {
+    // See what earlier runs learned about this task.
+    const std::string key = cache_ == nullptr ? "" : TaskKey(tasks[task]);
+    if (cache_ != nullptr) {
+      std::optional<SearchCache::Record> record = cache_->Lookup(key);
+      if (record.has_value() && record->bound < shared_best_score) return;
+      if (record.has_value() && record->exact) {
+        absl::StatusOr<Gamestate> board = BoardFromString(record->board);
+        if (!board.ok()) {
+          statuses[task] = board.status();
+          return;
+        }
+        scores[task] = record->bound;
+        states[task] = *board;
+        RaiseTo(shared_best_score, record->bound);
+        return;
+      }
+    }
+
+    Solver &worker = workers[w];
+    worker.state_ = state_;
+    worker.reservations_.clear();
+    worker.steps_.clear();
+    worker.InvalidateLines(~0u);
+    worker.RebuildLineIds();
+    worker.best_score_ = 0;
+    worker.best_state_ = state_;
+    for (int i = 0; i < tasks[task].fills.size(); ++i) {
+      const auto &[cells, letters] = tasks[task].fills[i];
+      if (absl::Status s =
+              worker.ApplyTechnique(TechniqueAt(i), cells, letters);
+          !s.ok()) {
+        statuses[task] = s;
+        return;
+      }
+    }
+    statuses[task] = worker.RecursiveHelper(tasks[task].fills.size(),
+                                            tasks[task].needs_new_tile);
+    scores[task] = worker.best_score_;
+    states[task] = worker.best_state_;
+    if (!statuses[task].ok() || cache_ == nullptr) return;
+
+    // Branches were only cut if they could not beat this task's best board or
+    // could not tie the shared best score. So if this task's best board is at
+    // least the shared best, nothing in the task beats it, and otherwise
+    // nothing in the task even ties the shared best. A task that found no
+    // scoring board has no board to record, so it is never exact.
+    const int shared = shared_best_score;
+    const bool exact = scores[task] > 0 && scores[task] >= shared;
+    std::string board;
+    for (int i = 0; exact && i < 25; ++i)
+      board.push_back(worker.best_state_[{.row = i / 5, .col = i % 5}].letter);
+    statuses[task] = cache_->Insert(
+        key, {.bound = exact ? scores[task] : std::max(shared - 1, 0),
+              .exact = exact,
+              .board = board});
+  });
+
+  // Merge in task order, which is the order a serial search would use.
+  for (int task = 0; task < tasks.size(); ++task) {
+    if (!statuses[task].ok()) {
+      LOG(ERROR) << statuses[task];
+      return statuses[task];
+    }
+    if (scores[task] > best_score_) {
+      best_score_ = scores[task];
+      best_state_ = states[task];
+    }
+  }
+  return absl::OkStatus();
+}
+
+std::string Solver::TaskKey(const Task &task) const {
+  // The parameters of the techniques left to apply, and if only new boards are
+  // to be searched, the parameters they are new relative to.
+  std::string params = RemainingTechniquesKey(params_);
+  if (task.needs_new_tile)
+    absl::StrAppend(&params, "-", RemainingTechniquesKey(*previous_params_));
+
+  const std::string root = absl::StrFormat(
+      "%v|%v|%s|%s|%d", state_, state_.unplaced_letters(),
+      PointsString(state_.MultiplierPoints()),
+      PointsString(state_.bonus_line()), dict_->version());
+  std::string letter_values;
+  for (char c = 'a'; c <= 'z'; ++c)
+    absl::StrAppend(&letter_values, state_.letter_value(c), ",");
+
+  std::string key = absl::StrCat(
+      absl::Hex(Fingerprint(absl::StrCat(root, "|", letter_values)),
+                absl::kZeroPad16),
+      "|", params);
+  for (const auto &[cells, letters] : task.fills)
+    absl::StrAppend(&key, "|", PointsString(cells), "=", letters);
+  return key;
+}
+
+absl::StatusOr<Gamestate> Solver::BoardFromString(
+    absl::string_view board) const {
+  if (board.size() != 25)
+    return absl::DataLossError(absl::StrFormat(kCachedBoardError, board));
+  Gamestate state = state_;
+  for (int i = 0; i < 25; ++i) {
+    const Point p = {.row = i / 5, .col = i % 5};
+    if (state[p].letter == board[i] || !std::isalpha(board[i])) continue;
+    if (absl::Status s = state.FillCell(p, board[i]); !s.ok()) {
+      LOG(ERROR) << s;
+      return absl::DataLossError(absl::StrFormat(kCachedBoardError, board));
+    }
+  }
+  return state;
+}
+
+absl::Status Solver::CollectTasks(int i, bool needs_new_tile,
+                                  std::vector<Fill> &prefix,
+                                  std::vector<Task> &tasks) {
+  if (i == params_.parallel_depth || IsComplete()) {
+    tasks.push_back({.fills = prefix, .needs_new_tile = needs_new_tile});
+    return absl::OkStatus();
+  }
+
+  const Branches branches = BranchesFor(i, needs_new_tile);
+  for (int j = 0; j < branches.options.size(); ++j) {
+    const std::string &letters = branches.options[j];
+    const bool still_needs_new_tile = needs_new_tile && !branches.is_new[j];
+    if (still_needs_new_tile && i >= LastWidenedTechnique()) continue;
+
+    if (absl::Status s =
+            ApplyTechnique(branches.technique, branches.cells, letters);
+        !s.ok()) {
       LOG(ERROR) << s;
       return s;
     }
-    // Recurse.
-    if (absl::Status s = RecursiveHelper(i + 1); !s.ok()) {
+    prefix.push_back({branches.cells, letters});
+    if (absl::Status s =
+            CollectTasks(i + 1, still_needs_new_tile, prefix, tasks);
+        !s.ok()) {
       LOG(ERROR) << s;
       return s;
     }
-    // Undo the placement.
+    prefix.pop_back();
     if (absl::Status s = ClearCells(); !s.ok()) {
       LOG(ERROR) << s;
       return s;
@@ -149,9 +597,44 @@ absl::Status Solver::RecursiveHelper(int i) {
 
 std::vector<Point> Solver::RemainingMultiplierCells() const {
   std::vector<Point> open_multiplier_points;
-  for (const Point &p : multiplier_points_)
-    if (state_[p].letter == kEmptyCell) open_multiplier_points.push_back(p);
-  return open_multiplier_points;
+  for (const Point &p : multiplier_points_) {
+    const int cell = 5 * p.row + p.col;
+    if (state_[p].letter == kEmptyCell &&
+        absl::c_none_of(reservations_, [cell](const Reservation &r) {
+          return r.cells & (1u << cell);
+        }))
+      open_multiplier_points.push_back(p);
+  }
+
+  std::vector<Point> grouped;
+  for (const std::vector<Point> &group :
+       InterchangeableCells(open_multiplier_points))
+    grouped.insert(grouped.end(), group.begin(), group.end());
+  return grouped;
+}
+
+std::vector<std::vector<Point>> Solver::InterchangeableCells(
+    const std::vector<Point> &cells) const {
+  std::vector<std::vector<Point>> groups;
+  std::vector<std::pair<int, bool>> keys;
+  for (const Point &p : cells) {
+    const std::pair<int, bool> key = {state_[p].multiplier,
+                                      absl::c_linear_search(bonus_line_, p)};
+    const int g = absl::c_find(keys, key) - keys.begin();
+    if (g == keys.size()) {
+      keys.push_back(key);
+      groups.push_back({});
+    }
+    groups[g].push_back(p);
+  }
+  return groups;
+}
+
+absl::Status Solver::ApplyTechnique(Technique t,
+                                    const std::vector<Point> &cells,
+                                    absl::string_view letters) {
+  return t == Technique::kFillMultiplierCells ? ReserveCells(cells, letters)
+                                              : FillCells(cells, letters);
 }
 
 absl::Status Solver::FillCells(const std::vector<Point> &cells,
@@ -161,19 +644,69 @@ absl::Status Solver::FillCells(const std::vector<Point> &cells,
     return s;
   }
 
-  locks_.push_back({});
+  Step step = {.reservations = reservations_,
+               .line_ids = line_ids_,
+               .line_ids_masks = line_ids_masks_};
   for (const Point &p : cells) {
     if (state_[p].is_locked) continue;
-    locks_.back().insert(p);
+    const int cell = 5 * p.row + p.col;
+    step.locks |= 1u << cell;
     state_[p].is_locked = true;
+
+    // Take the letter from the cell's reservation, if it has one.
+    for (Reservation &r : reservations_) {
+      if (!(r.cells & (1u << cell))) continue;
+      r.cells &= ~(1u << cell);
+      if (absl::Status s = r.letters.RemoveLetter(state_[p].letter); !s.ok()) {
+        LOG(ERROR) << s;
+        return s;
+      }
+    }
+  }
+  std::erase_if(reservations_, [](const Reservation &r) { return !r.cells; });
+  steps_.push_back(std::move(step));
+  InvalidateLines(steps_.back().locks);
+  return absl::OkStatus();
+}
+
+absl::Status Solver::ReserveCells(const std::vector<Point> &cells,
+                                  absl::string_view letters) {
+  // Cells without an interchangeable partner are filled straight away.
+  std::vector<Point> singles;
+  std::string single_letters;
+  std::vector<Reservation> reserved;
+  int j = 0;
+  for (const std::vector<Point> &group : InterchangeableCells(cells)) {
+    const absl::string_view group_letters = letters.substr(j, group.size());
+    j += group.size();
+    if (group.size() == 1) {
+      singles.push_back(group[0]);
+      absl::StrAppend(&single_letters, group_letters);
+      continue;
+    }
+    Reservation r = {.letters = LetterCount(group_letters)};
+    for (const Point &p : group) r.cells |= 1u << (5 * p.row + p.col);
+    reserved.push_back(r);
+  }
+
+  if (absl::Status s = FillCells(singles, single_letters); !s.ok()) {
+    LOG(ERROR) << s;
+    return s;
   }
+  reservations_.insert(reservations_.end(), reserved.begin(), reserved.end());
   return absl::OkStatus();
 }
 
 absl::Status Solver::ClearCells() {
-  absl::flat_hash_set<Point> locks = locks_.back();
-  locks_.pop_back();
-  for (const Point &p : locks) {
+  Step step = std::move(steps_.back());
+  steps_.pop_back();
+  reservations_ = std::move(step.reservations);
+  line_ids_ = std::move(step.line_ids);
+  line_ids_masks_ = step.line_ids_masks;
+  InvalidateLines(step.locks);
+  for (int i = 0; i < 25; ++i) {
+    if (!(step.locks & (1u << i))) continue;
+    const Point p = {.row = i / 5, .col = i % 5};
     state_[p].is_locked = false;
     if (absl::Status s = state_.ClearCell(p); !s.ok()) {
       LOG(ERROR) << s;
@@ -183,22 +716,177 @@ absl::Status Solver::ClearCells() {
   return absl::OkStatus();
 }
 
+/** * * * * * * *
+ * Reservations *
+ * * * * * * * **/
+
+LetterCount Solver::ReservedLetters() const {
+  LetterCount reserved;
+  for (const Reservation &r : reservations_) reserved += r.letters;
+  return reserved;
+}
+
+std::string Solver::MostValuableFreeLetters(int n) const {
+  LetterCount reserved = ReservedLetters();
+  std::string letters;
+  for (const char c : state_.NMostValuableLetters(25)) {
+    if (letters.size() >= n) break;
+    if (reserved.contains(c))
+      reserved -= absl::string_view(&c, 1);
+    else
+      letters.push_back(c);
+  }
+  return letters;
+}
+
+std::vector<std::string> Solver::PatternFor(
+    const std::vector<Point> &line) const {
+  std::vector<std::string> pattern = state_.LinePattern(line);
+  if (reservations_.empty()) return pattern;
+
+  const std::string free =
+      (state_.unplaced_letters() - ReservedLetters()).UniqueLetters();
+  for (int j = 0; j < line.size(); ++j) {
+    const Point &p = line[j];
+    if (state_[p].letter != kEmptyCell) continue;
+    pattern[j] = free;
+    for (const Reservation &r : reservations_)
+      if (r.cells & (1u << (5 * p.row + p.col)))
+        pattern[j] = r.letters.UniqueLetters();
+  }
+  return pattern;
+}
+
+bool Solver::RespectsReservations(const std::vector<Point> &line,
+                                  absl::string_view word) const {
+  std::vector<LetterCount> needed(reservations_.size());
+  LetterCount needed_free;
+  for (int j = 0; j < line.size(); ++j) {
+    const Point &p = line[j];
+    if (state_[p].letter != kEmptyCell) continue;
+    const int cell = 5 * p.row + p.col;
+    const int r = absl::c_find_if(reservations_,
+                                  [cell](const Reservation &r) {
+                                    return r.cells & (1u << cell);
+                                  }) -
+                  reservations_.begin();
+    if (absl::Status s = (r < reservations_.size() ? needed[r] : needed_free)
+                             .AddLetter(word[j]);
+        !s.ok())
+      return false;
+  }
+  for (int r = 0; r < reservations_.size(); ++r)
+    if (!reservations_[r].letters.contains(needed[r])) return false;
+  return (state_.unplaced_letters() - ReservedLetters()).contains(needed_free);
+}
+
+/** * * * * * * * * * *
+ * Constraint tracking *
+ * * * * * * * * * * * **/
+
+std::array<uint32_t, 25> Solver::CellLetterMasks() const {
+  uint32_t free_letters = 0;
+  for (const char c :
+       (state_.unplaced_letters() - ReservedLetters()).UniqueLetters())
+    free_letters |= 1u << (c - 'a');
+
+  std::array<uint32_t, 25> masks;
+  masks.fill(free_letters);
+  for (const Reservation &r : reservations_) {
+    uint32_t reserved_letters = 0;
+    for (const char c : r.letters.UniqueLetters())
+      reserved_letters |= 1u << (c - 'a');
+    for (int c = 0; c < 25; ++c)
+      if (r.cells & (1u << c)) masks[c] = reserved_letters;
+  }
+  for (int c = 0; c < 25; ++c) {
+    const char l = state_[{.row = c / 5, .col = c % 5}].letter;
+    if (l != kEmptyCell) masks[c] = 1u << (l - 'a');
+  }
+  return masks;
+}
+
+void Solver::RebuildLineIds() {
+  const std::array<uint32_t, 25> masks = CellLetterMasks();
+  line_ids_masks_ = masks;
+  line_ids_.assign(lines_.size(), {});
+  for (int i = 0; i < lines_.size(); ++i) {
+    if (absl::c_none_of(lines_[i], [this](const Point &p) {
+          return state_[p].letter == kEmptyCell;
+        }))
+      continue;
+    std::vector<std::string> pattern;
+    for (const Point &p : lines_[i]) {
+      std::string letters;
+      for (char c = 'a'; c <= 'z'; ++c)
+        if (masks[5 * p.row + p.col] & (1u << (c - 'a'))) letters.push_back(c);
+      // An empty pattern would allow any letter, so use one matching nothing.
+      pattern.push_back(letters.empty() ? "-" : letters);
+    }
+    line_ids_[i] = dict_->WordIdsMatchingPattern(pattern);
+  }
+}
+
+const std::vector<Dict::WordBitset> &Solver::LineIds() const {
+  const std::array<uint32_t, 25> after = CellLetterMasks();
+  if (after == line_ids_masks_) return line_ids_;
+  const std::array<uint32_t, 25> &before = line_ids_masks_;
+  for (int i = 0; i < lines_.size(); ++i) {
+    const std::vector<Point> &line = lines_[i];
+    Dict::WordBitset &ids = line_ids_[i];
+    if (ids.empty()) continue;
+
+    // Full lines are scored as they are, so their words are no longer needed.
+    if (absl::c_none_of(line, [this](const Point &p) {
+          return state_[p].letter == kEmptyCell;
+        })) {
+      ids.clear();
+      continue;
+    }
+    for (int j = 0; j < line.size(); ++j) {
+      const int c = 5 * line[j].row + line[j].col;
+      const uint32_t lost = before[c] & ~after[c];
+      if (lost == 0) continue;
+
+      // Remove the words with a lost letter, or keep only those with a kept
+      // letter, whichever takes fewer bitsets. Filling a cell keeps just one.
+      if (std::popcount(lost) <= std::popcount(after[c])) {
+        for (uint32_t l = lost; l != 0; l &= l - 1) {
+          const Dict::WordBitset &with_letter = dict_->WordIdsWithLetter(
+              line.size(), j, 'a' + std::countr_zero(l));
+          for (int b = 0; b < ids.size(); ++b) ids[b] &= ~with_letter[b];
+        }
+      } else {
+        Dict::WordBitset kept(ids.size());
+        for (uint32_t l = after[c]; l != 0; l &= l - 1) {
+          const Dict::WordBitset &with_letter = dict_->WordIdsWithLetter(
+              line.size(), j, 'a' + std::countr_zero(l));
+          for (int b = 0; b < ids.size(); ++b) kept[b] |= with_letter[b];
+        }
+        for (int b = 0; b < ids.size(); ++b) ids[b] &= kept[b];
+      }
+    }
+  }
+  line_ids_masks_ = after;
+  return line_ids_;
+}
+
 /** * * * **
  * Options *
  ** * * * **/
 
-absl::flat_hash_set<std::string> Solver::OptionsForBonusWord() const {
+absl::flat_hash_set<std::string> Solver::OptionsForBonusWord(
+    int num_tiles) const {
   const LetterCount line_contents(state_.LineString(bonus_line_));
   Dict::SearchParameters params = {
       .min_length = 4,
       .max_length = 4,
       .max_letters = state_.unplaced_letters() + line_contents,
-      .matching_regex = state_.LineRegex(bonus_line_)};
+      .letters_by_position = PatternFor(bonus_line_)};
 
   // We narrow the possible bonus words by requiring they use a certain number
   // of the most valuable tiles.
-  const LetterCount top_letters(
-      state_.NMostValuableLetters(params_.num_tiles_for_bonus_words));
+  const LetterCount top_letters(MostValuableFreeLetters(num_tiles));
   absl::flat_hash_set<std::string> combos =
       top_letters.CombinationsOfSize(3 - line_contents.size());
 
@@ -207,9 +895,14 @@ absl::flat_hash_set<std::string> Solver::OptionsForBonusWord() const {
   for (const absl::string_view combo : combos) {
     params.min_letters = LetterCount(combo);
     absl::flat_hash_set<std::string> words =
-        dict_.WordsMatchingParameters(params);
+        dict_->WordsMatchingParameters(params);
     options.insert(words.begin(), words.end());
   }
+  if (!reservations_.empty()) {
+    absl::erase_if(options, [this](const std::string &word) {
+      return !RespectsReservations(bonus_line_, word);
+    });
+  }
   return options;
 }
 
@@ -217,68 +910,241 @@ absl::flat_hash_set<std::string> Solver::OptionsForLine(
     const std::vector<Point> &line) const {
   const LetterCount line_contents(state_.LineString(line));
   const int n = line.size();
-  return dict_.WordsMatchingParameters(
+
+  // The words that fit each cell of a scored line are already tracked, so only
+  // their letter counts need checking.
+  if (const int i = absl::c_find(lines_, line) - lines_.begin();
+      i < lines_.size()) {
+    const LetterCount max_letters = line_contents + state_.unplaced_letters();
+    absl::flat_hash_set<std::string> options;
+    const Dict::WordBitset &ids = LineIds()[i];
+    for (int b = 0; b < ids.size(); ++b) {
+      for (uint64_t bits = ids[b]; bits != 0; bits &= bits - 1) {
+        const std::string &word =
+            dict_->WordWithId(n, 64 * b + std::countr_zero(bits));
+        if (max_letters.contains(word) && RespectsReservations(line, word))
+          options.insert(word);
+      }
+    }
+    return options;
+  }
+
+  absl::flat_hash_set<std::string> options = dict_->WordsMatchingParameters(
       {.min_length = n,  // TODO: 3
        .max_length = n,
        .min_letters = line_contents,
        .max_letters = line_contents + state_.unplaced_letters(),
-       .matching_regex = state_.LineRegex(line)});
+       .letters_by_position = PatternFor(line)});
+  if (!reservations_.empty()) {
+    absl::erase_if(options, [this, &line](const std::string &word) {
+      return !RespectsReservations(line, word);
+    });
+  }
+  return options;
 }
 
-absl::flat_hash_set<std::string> Solver::OptionsForMultiplierTiles() const {
+void Solver::OptionsForMultiplierTiles(
+    int num_tiles, absl::FunctionRef<void(absl::string_view)> visit) const {
   // We only consider a certain number of high-value letters to place on the
   // multiplier tiles.
-  const LetterCount top_letters(
-      state_.NMostValuableLetters(params_.num_tiles_for_mult_cells));
-  const int k = absl::c_count_if(multiplier_points_, [*this](const Point &p) {
-    return state_[p].letter == kEmptyCell;
-  });
-  absl::flat_hash_set<std::string> combos = top_letters.CombinationsOfSize(k);
+  LetterCount top_letters(MostValuableFreeLetters(num_tiles));
+  std::vector<int> group_sizes;
+  for (const std::vector<Point> &group :
+       InterchangeableCells(RemainingMultiplierCells()))
+    group_sizes.push_back(group.size());
 
-  // Get the permutations of each combination.
-  absl::flat_hash_set<std::string> options;
-  for (std::string combo : combos) {
-    do options.insert(combo);
-    while (std::next_permutation(combo.begin(), combo.end()));
-  }
-  return options;
+  std::string drawn;
+  DrawSortedLetters(group_sizes, 0, 'a', top_letters, drawn, visit);
 }
 
 /** * * * **
  * Scoring *
  ** * * * **/
 
-int Solver::LineScore(const std::vector<Point> &line) const {
-  const std::string word = GetWord(line);
-  if (!dict_.contains(word)) return 0;
+const Solver::ScoredLine &Solver::ScoreLine(int i) const {
+  ScoredLine &scored = scored_lines_[i];
+  if (scored.is_current) return scored;
+  scored = {.is_current = true};
+
+  const std::vector<Point> &line = lines_[i];
+  const std::string line_string = state_.LineString(line);
+  std::string word = LongestAlphaSubstring(line_string);
+  const int threshold = (line == bonus_line_) ? 4 : 3;
+  if (word.length() < threshold || !dict_->contains(word)) return scored;
 
   // Find the index in line where word begins.
-  int offset = 0;
-  while (state_.LineString(line).substr(offset, word.size()) != word) ++offset;
+  const int offset = line_string.find(word);
 
   int score = 0;
-  for (int i = 0; i < word.size(); ++i) {
-    char c = word[i];
-    score += state_.letter_values().at(c) * state_[line[i + offset]].multiplier;
+  for (int j = 0; j < word.size(); ++j) {
+    char c = word[j];
+    score += state_.letter_value(c) * state_[line[j + offset]].multiplier;
   }
-  return std::ceil(score * (dict_.IsCommonWord(word) ? 1.3 : 1));
+  scored.is_common = dict_->IsCommonWord(word);
+  scored.score = std::ceil(score * (scored.is_common ? 1.3 : 1));
+  scored.word = std::move(word);
+  return scored;
+}
+
+void Solver::InvalidateLines(uint32_t cells) {
+  uint8_t lines = 0;
+  for (int c = 0; c < 25; ++c)
+    if (cells & (1u << c)) lines |= lines_through_cell_[c];
+  for (int i = 0; i < lines_.size(); ++i)
+    if (lines & (1u << i)) scored_lines_[i].is_current = false;
 }
 
 int Solver::Score() const {
   int score = 0;
-  for (const std::vector<Point> &line : lines_) score += LineScore(line);
+  for (int i = 0; i < lines_.size(); ++i) score += LineScore(i);
   return score;
 }
 
+int Solver::UpperBound() const {
+  int exact = 0;
+  int open_lines = 0;
+  int open_score = 0;
+  std::array<int, 25> empty_cell_weights = {};
+  for (int i = 0; i < lines_.size(); ++i) {
+    const std::vector<Point> &line = lines_[i];
+    if (absl::c_none_of(line, [this](const Point &p) {
+          return state_[p].letter == kEmptyCell;
+        })) {
+      exact += LineScore(i);
+      continue;
+    }
+    ++open_lines;
+    for (const Point &p : line) {
+      const Cell &cell = state_[p];
+      if (cell.letter == kEmptyCell)
+        empty_cell_weights[5 * p.row + p.col] += cell.multiplier;
+      else
+        open_score += state_.letter_value(cell.letter) * cell.multiplier;
+    }
+  }
+
+  // Reserved letters go on their own cells, whose weights are all equal.
+  for (const Reservation &r : reservations_) {
+    int weight = 0;
+    for (int c = 0; c < 25; ++c) {
+      if (!(r.cells & (1u << c))) continue;
+      weight = empty_cell_weights[c];
+      empty_cell_weights[c] = 0;
+    }
+    for (const char c : r.letters.CharsInOrder())
+      open_score += state_.letter_value(c) * weight;
+  }
+
+  // Pair the most valuable free tiles with the heaviest other cells.
+  std::sort(empty_cell_weights.begin(), empty_cell_weights.end(),
+            std::greater<int>());
+  const std::string tiles = MostValuableFreeLetters(25);
+  for (int i = 0; i < tiles.size(); ++i)
+    open_score += state_.letter_value(tiles[i]) * empty_cell_weights[i];
+
+  // Each open line's score is at most ceil(1.3 * its share of `open_score`).
+  return exact + (13 * open_score + 9 * open_lines) / 10;
+}
+
+bool Solver::CanBeatBestScore() const {
+  const int bound = UpperBound();
+  if (bound <= best_score_) return false;
+  return shared_best_score_ == nullptr || bound >= *shared_best_score_;
+}
+
+bool Solver::IsFeasible() const {
+  // Every full line must be a word. The others must already score a word, or
+  // still have one that fits the letters each of their empty cells may take.
+  std::vector<int> open_lines;
+  uint8_t open_line_bits = 0;
+  for (int i = 0; i < lines_.size(); ++i) {
+    if (absl::c_none_of(lines_[i], [this](const Point &p) {
+          return state_[p].letter == kEmptyCell;
+        })) {
+      if (GetWord(i).empty()) return false;
+      continue;
+    }
+    if (!GetWord(i).empty()) continue;
+    if (absl::c_all_of(LineIds()[i], [](uint64_t b) { return b == 0; }))
+      return false;
+    open_lines.push_back(i);
+    open_line_bits |= 1 << i;
+  }
+
+  // Whether `word` could fill `lines_[i]` with the letters left, each empty
+  // cell taking one of the letters in `masks`.
+  std::array<uint32_t, 25> masks = CellLetterMasks();
+  const LetterCount free = state_.unplaced_letters() - ReservedLetters();
+  auto fits = [&](int i, absl::string_view word) {
+    const std::vector<Point> &line = lines_[i];
+    std::array<int, 26> needed = {};
+    for (int j = 0; j < line.size(); ++j) {
+      const Point &p = line[j];
+      if (state_[p].letter != kEmptyCell) continue;
+      if (!(masks[5 * p.row + p.col] & (1u << (word[j] - 'a')))) return false;
+      if (++needed[word[j] - 'a'] > free.count(word[j]) &&
+          reservations_.empty())
+        return false;
+    }
+    return reservations_.empty() || RespectsReservations(line, word);
+  };
+
+  // Each open line needs a word that fits. Where two open lines cross, the
+  // shared cell is narrowed to the letters that fitting words put there, which
+  // may in turn leave the other line with none, so repeat until stable.
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (const int i : open_lines) {
+      const std::vector<Point> &line = lines_[i];
+      std::vector<int> shared;
+      for (int j = 0; j < line.size(); ++j) {
+        const int c = 5 * line[j].row + line[j].col;
+        if (state_[line[j]].letter == kEmptyCell &&
+            std::popcount<uint8_t>(lines_through_cell_[c] & open_line_bits) > 1)
+          shared.push_back(j);
+      }
+
+      bool has_word = false;
+      std::array<uint32_t, 5> seen = {};
+      const Dict::WordBitset &ids = LineIds()[i];
+      for (int b = 0; b < ids.size(); ++b) {
+        for (uint64_t bits = ids[b]; bits != 0; bits &= bits - 1) {
+          const std::string &word =
+              dict_->WordWithId(line.size(), 64 * b + std::countr_zero(bits));
+          if (!fits(i, word)) continue;
+          has_word = true;
+          if (shared.empty()) break;
+          for (const int j : shared) seen[j] |= 1u << (word[j] - 'a');
+        }
+        if (has_word && shared.empty()) break;
+      }
+      if (!has_word) return false;
+
+      for (const int j : shared) {
+        uint32_t &mask = masks[5 * line[j].row + line[j].col];
+        if (seen[j] == mask) continue;
+        mask = seen[j];
+        changed = true;
+      }
+    }
+  }
+  return true;
+}
+
 void Solver::UpdateBestState() {
   if (int score = Score(); score > best_score_) {
     best_score_ = score;
-    best_state_ = state();
+    best_state_ = state_;
+
+    // When searching in parallel, only report scores that beat every worker.
+    if (shared_best_score_ != nullptr && !RaiseTo(*shared_best_score_, score))
+      return;
+
     LOG(INFO) << absl::StrCat("New best score! (", best_score_, ")");
-    for (const std::vector<Point> &line : lines_) {
-      std::string word = GetWord(line);
-      LOG(INFO) << absl::StrCat(LineScore(line), " - ", word,
-                                (dict_.IsCommonWord(word) ? " is" : " isn't"),
+    for (int i = 0; i < lines_.size(); ++i) {
+      const ScoredLine &line = ScoreLine(i);
+      LOG(INFO) << absl::StrCat(line.score, " - ", line.word,
+                                (line.is_common ? " is" : " isn't"),
                                 " a common word.");
     }
     LOG(INFO) << best_state_;
@@ -289,27 +1155,25 @@ void Solver::UpdateBestState() {
  * Words *
  ** * * **/
 
-std::string Solver::GetWord(const std::vector<Point> &line) const {
-  const int threshold = (line == bonus_line_) ? 4 : 3;
-  const std::string word = LongestAlphaSubstring(state().LineString(line));
-  return (word.length() >= threshold && dict_.contains(word)) ? word : "";
-}
-
 bool Solver::IsComplete() const {
-  return std::none_of(lines_.begin(), lines_.end(),
-                      [*this](const std::vector<Point> &line) {
-                        return GetWord(line).empty();
-                      });
+  for (int i = 0; i < lines_.size(); ++i)
+    if (GetWord(i).empty()) return false;
+  return true;
 }
 
 int Solver::MostRestrictedWordlessRow() const {
   int most_letters_placed = INT_MIN;
   int row_to_focus = 0;
   for (int row = 0; row < 5; ++row) {
-    if (!(GetWord(lines_[row]).empty())) continue;
-    const int letters = absl::c_count_if(
-        state().grid()[row],
-        [](const Cell &cell) { return cell.letter != kEmptyCell; });
+    if (!(GetWord(row).empty())) continue;
+    // Reserved cells restrict a row almost as much as placed letters.
+    uint32_t reserved = 0;
+    for (const Reservation &r : reservations_) reserved |= r.cells;
+    int letters = 0;
+    for (int col = 0; col < 5; ++col)
+      if (state_[row][col].letter != kEmptyCell ||
+          reserved & (1u << (5 * row + col)))
+        ++letters;
     if (letters > most_letters_placed) {
       most_letters_placed = letters;
       row_to_focus = row;
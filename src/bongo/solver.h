@@ -9,10 +9,21 @@
 #ifndef PUZZMO_BONGO_SOLVER_H_
 #define PUZZMO_BONGO_SOLVER_H_
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "dict.h"
 #include "gamestate.h"
+#include "search_cache.h"
 
 namespace puzzmo::bongo {
 
@@ -64,6 +75,34 @@ class Solver {
     // place on the multiplier tiles. Note that increasing this n scales by
     // O(n^2).
     int num_tiles_for_mult_cells = 4;
+
+    // The number of threads to search with. If greater than 1, the branches at
+    // the first `parallel_depth` levels of the search are enumerated up front
+    // and shared out between threads. The result is the same as that of a
+    // serial search.
+    int num_threads = 1;
+
+    // How many levels of the search to enumerate before handing the branches
+    // out to threads. 1 is usually plenty; 2 balances better when there are
+    // few top-level branches.
+    int parallel_depth = 1;
+
+    // The number of extra rounds to search once a solution has been found.
+    // Each round admits one more tile to `num_tiles_for_bonus_words` and
+    // `num_tiles_for_mult_cells`, and only searches boards that use one of the
+    // newly admitted tiles. The best board is kept across rounds.
+    int widening_rounds = 0;
+
+    // Whether to search best-first instead of depth-first. Partial boards wait
+    // in a queue, and the one with the highest `UpperBound()` is expanded
+    // next, so the search heads for the best boards rather than the first
+    // ones. Threads and caches are not used when searching best-first.
+    bool best_first = false;
+
+    // The most partial boards to queue when searching best-first, which bounds
+    // its memory use. Once that many have been queued, new branches are
+    // searched depth-first on the spot.
+    int max_queued_states = 1 << 20;
   };
 
   /** * * * * * * *
@@ -82,7 +121,7 @@ class Solver {
   // Solver::dict()
   //
   // Provides access to the underlying `Dict`.
-  Dict dict() const { return dict_; }
+  const Dict &dict() const { return *dict_; }
 
   // Solver::starting_state()
   //
@@ -113,6 +152,14 @@ class Solver {
   // Returns the solver to its starting state.
   void reset();
 
+  // Solver::set_cache()
+  //
+  // Has `Solve()` consult and update `cache`, which must outlive the solver.
+  // Top-level branches explored in earlier runs, with the same board, tiles,
+  // dictionary and parameters, are then skipped or answered from the cache.
+  // Pass `nullptr` to stop using a cache.
+  void set_cache(SearchCache *cache) { cache_ = cache; }
+
   // Solver::Solve()
   //
   // Applies `techniques_` in order, depth-first, ending each branch when
@@ -122,40 +169,258 @@ class Solver {
   // every branch of the search, if the current gamestate scores higher than
   // `best_score_`, it is saved as `best_state_` and `best_score_` is updated.
   //
-  // If no solutions are found, the process is repeated from the top with
-  // `tiles_for_bonus_words_` and `tiles_for_multiplier_tiles_` both
-  // incremented.
+  // If no solutions are found, the search is widened as with
+  // `Parameters::widening_rounds` until one is found, or until there are no
+  // tiles left to admit, in which case an error is returned.
+  //
+  // If `Parameters::num_threads` is greater than 1, the search is split
+  // between that many threads, and returns the same board. Likewise if a cache
+  // has been provided with `set_cache()`.
+  //
+  // If `Parameters::best_first` is true, the search is run by
+  // `BestFirstHelper()` instead, and finds a board with the same score.
+  //
+  // Either way, every new best board is logged as soon as it is found.
   absl::StatusOr<Gamestate> Solve();
 
  private:
+  // Lets tests reach the search's internals.
+  friend class SolverPeer;
+
+  // A single step of the search: the letters placed in some cells.
+  using Fill = std::pair<std::vector<Point>, std::string>;
+
+  // Solver::Task
+  //
+  // A branch of the search to be searched as a unit, and the fills that lead
+  // to it. If `needs_new_tile` is true, none of the fills used a newly
+  // admitted tile, so only the boards below it that do remain to be searched.
+  struct Task {
+    std::vector<Fill> fills;
+    bool needs_new_tile = false;
+  };
+
+  // Solver::Branches
+  //
+  // The cells targeted by a technique and the options for filling them. If the
+  // search has been widened, `is_new[j]` is true if `options[j]` could not
+  // have been chosen before the latest widening.
+  struct Branches {
+    Technique technique;
+    std::vector<Point> cells;
+    std::vector<std::string> options;
+    std::vector<bool> is_new;
+  };
+
+  // Solver::TechniqueAt()
+  //
+  // Returns the `i`th technique in `techniques_`, or
+  // `Technique::kFillMostRestrictedRow` once they run out.
+  Technique TechniqueAt(int i) const;
+
+  // Solver::BranchesFor()
+  //
+  // Returns the branches of the search at depth `i`: the cells targeted by
+  // `TechniqueAt(i)` and its options. Options are ordered best-first, by the
+  // value of their letters on the targeted cells, so that good boards are
+  // found early and bound the rest of the search. Ties are broken
+  // alphabetically so that every search visits them in the same order.
+  // `is_new` is only filled in if `needs_new_tile` is true.
+  Branches BranchesFor(int i, bool needs_new_tile) const;
+
   // Solver::RecursiveHelper()
   //
   // If the gamestate is complete, checks to see if we have a new best state.
   // Otherwise, applies the `i`th technique in `techniques_`, gathering the
   // corresponding options and calling the corresponding filler method, and then
-  // calls itself with `i` incremented.
+  // calls itself with `i` incremented. Options whose `UpperBound()` cannot beat
+  // the best score found so far, or that are not `IsFeasible()`, are skipped.
   //
   // After all techniques in the vector have been used, the technique
   // `Technique::kFillMostRestrictedRow` will be used to finish the boards.
-  absl::Status RecursiveHelper(int i);
+  //
+  // If `needs_new_tile` is true, only boards that use a tile admitted by the
+  // latest widening are searched, as the rest were searched in earlier rounds.
+  absl::Status RecursiveHelper(int i, bool needs_new_tile);
+
+  // Solver::BestFirstHelper()
+  //
+  // Does the work of `RecursiveHelper(0)` best-first. Each `Node` is expanded
+  // by applying its next technique, and each resulting board that could still
+  // beat the best score is queued, or searched depth-first once
+  // `Parameters::max_queued_states` boards have been. Boards queued before are
+  // skipped. The search ends once no queued board can beat the best score.
+  absl::Status BestFirstHelper(bool needs_new_tile);
+
+  // Solver::LastWidenedTechnique()
+  //
+  // Returns the index of the last technique in `techniques_` whose options
+  // depend on the number of tiles considered, or -1 if there is none. Once past
+  // it, a branch that has not used a newly admitted tile never will.
+  int LastWidenedTechnique() const;
+
+  // Solver::Widen()
+  //
+  // Admits one more tile for the bonus word and multiplier cells, remembering
+  // the previous parameters in `previous_params_`. Returns `false`, changing
+  // nothing, if no new tile can be admitted.
+  bool Widen();
+
+  // Solver::TaskHelper()
+  //
+  // Does the work of `RecursiveHelper(0)` on `Parameters::num_threads`
+  // threads. Each top-level branch becomes a task that a worker, with its own
+  // copy of the solver and its gamestate, searches to completion. Results are
+  // merged in task order, so that ties go to the same board a serial search
+  // would have found first.
+  //
+  // If there is a cache, each task is first looked up in it. A task that
+  // cannot beat the best score so far is skipped, and one whose best board is
+  // known is answered directly. Every task that is searched is recorded.
+  absl::Status TaskHelper();
+
+  // Solver::TaskKey()
+  //
+  // Returns the cache key for `task`. It covers everything that affects the
+  // outcome of searching the task: the board, the tiles and their values, the
+  // dictionary, the parameters of any techniques left to apply, and the fills
+  // that reach the task.
+  std::string TaskKey(const Task &task) const;
+
+  // Solver::BoardFromString()
+  //
+  // Returns `state_` with its empty cells filled in from `board`, a string of
+  // the 25 cells in row-major order as stored by `SearchCache`.
+  absl::StatusOr<Gamestate> BoardFromString(absl::string_view board) const;
+
+  // Solver::CollectTasks()
+  //
+  // Appends to `tasks` the fills leading to every branch at depth
+  // `Parameters::parallel_depth`, or to any complete board found above it.
+  // Branches are skipped as in `RecursiveHelper()`.
+  absl::Status CollectTasks(int i, bool needs_new_tile,
+                            std::vector<Fill> &prefix,
+                            std::vector<Task> &tasks);
 
   // Solver::RemainingMultiplierCells()
   //
   // A simple helper function that returns `multiplier_cells_` without any that
-  // already contain letters.
+  // already contain or have been reserved letters. Cells are grouped as by
+  // `InterchangeableCells()`.
   std::vector<Point> RemainingMultiplierCells() const;
 
+  // Solver::InterchangeableCells()
+  //
+  // Splits `cells` into groups of cells that are interchangeable for scoring:
+  // those with the same multiplier that are all on, or all off, the bonus line.
+  // Groups are in order of their first cell in `cells`.
+  std::vector<std::vector<Point>> InterchangeableCells(
+      const std::vector<Point> &cells) const;
+
+  // Solver::ApplyTechnique()
+  //
+  // Applies one option of technique `t` to `cells`, with `ReserveCells()` for
+  // `Technique::kFillMultiplierCells` and `FillCells()` otherwise.
+  absl::Status ApplyTechnique(Technique t, const std::vector<Point> &cells,
+                              absl::string_view letters);
+
   // Solver::FillCells()
   //
-  // Makes the relevant modification to `state_`.
+  // Makes the relevant modification to `state_`. Letters placed on reserved
+  // cells are taken from their `Reservation`.
   absl::Status FillCells(const std::vector<Point> &cells,
                          const absl::string_view letters);
 
+  // Solver::ReserveCells()
+  //
+  // Sets `letters` aside for `cells`, which are grouped as by
+  // `InterchangeableCells()` and each sorted within its group. A cell with no
+  // interchangeable partner gets its letter straight away. Otherwise, which
+  // cell of a group gets which of its letters is left to the words that later
+  // cross those cells.
+  absl::Status ReserveCells(const std::vector<Point> &cells,
+                            absl::string_view letters);
+
   // Solver::ClearCells()
   //
-  // Unlocks the cells most recent modified in `state_` and clears them.
+  // Undoes the most recent `FillCells()` or `ReserveCells()`, unlocking the
+  // cells it modified in `state_` and clearing them.
   absl::Status ClearCells();
 
+  /** * * * * * * *
+   * Reservations *
+   * * * * * * * **/
+
+  // Solver::Reservation
+  //
+  // Letters set aside for a group of interchangeable cells that are still
+  // empty. Bit `5*row+col` of `cells` is set for each of them, and `letters`
+  // holds as many letters as there are cells.
+  struct Reservation {
+    uint32_t cells = 0;
+    LetterCount letters;
+
+    friend bool operator==(const Reservation &lhs, const Reservation &rhs) {
+      return lhs.cells == rhs.cells && lhs.letters == rhs.letters;
+    }
+
+    template <typename H>
+    friend H AbslHashValue(H h, const Reservation &r) {
+      return H::combine(std::move(h), r.cells, r.letters);
+    }
+  };
+
+  // Solver::Node
+  //
+  // A partial board waiting to be expanded by `BestFirstHelper()`, with the
+  // depth of the search at which it was reached and its `UpperBound()`. Nodes
+  // with equal bounds are expanded deepest first, then in the order they were
+  // queued.
+  struct Node {
+    int bound;
+    int depth;
+    bool needs_new_tile;
+    int64_t order;
+    Gamestate state;
+    std::vector<Reservation> reservations;
+  };
+
+  // Solver::Step
+  //
+  // What one `FillCells()` or `ReserveCells()` call changed, for
+  // `ClearCells()` to undo: bit `5*row+col` of `locks` is set if the call
+  // locked that cell, and the other fields are the members of the same name
+  // from before the call.
+  struct Step {
+    uint32_t locks = 0;
+    std::vector<Reservation> reservations;
+    std::vector<Dict::WordBitset> line_ids;
+    std::array<uint32_t, 25> line_ids_masks;
+  };
+
+  // Solver::ReservedLetters()
+  //
+  // Returns every letter in `reservations_`.
+  LetterCount ReservedLetters() const;
+
+  // Solver::MostValuableFreeLetters()
+  //
+  // As `Gamestate::NMostValuableLetters()`, but skipping reserved letters.
+  std::string MostValuableFreeLetters(int n) const;
+
+  // Solver::PatternFor()
+  //
+  // As `Gamestate::LinePattern()`, but a reserved cell may only take the
+  // letters reserved for it, and any other empty cell only free letters.
+  std::vector<std::string> PatternFor(const std::vector<Point> &line) const;
+
+  // Solver::RespectsReservations()
+  //
+  // Returns `true` if placing `word` in `line` would take each reserved cell's
+  // letter from its reservation and every other letter from the free ones.
+  bool RespectsReservations(const std::vector<Point> &line,
+                            absl::string_view word) const;
+
   /** * * * **
    * Options *
    ** * * * **/
@@ -164,9 +429,9 @@ class Solver {
   //
   // Calculates and returns all words to be tried in the bonus word slot. In
   // addition to the available letters, options are limited by the dictionary,
-  // the letters already placed in the bonus word, and by
-  // `Parameters::tiles_for_bonus_words`.
-  absl::flat_hash_set<std::string> OptionsForBonusWord() const;
+  // the letters already placed in the bonus word, and by `num_tiles`, normally
+  // `Parameters::num_tiles_for_bonus_words`.
+  absl::flat_hash_set<std::string> OptionsForBonusWord(int num_tiles) const;
 
   // Solver::OptionsForLine()
   //
@@ -178,32 +443,116 @@ class Solver {
 
   // Solver::OptionsForMultiplierTiles()
   //
-  // Calculates and returns all words to be tried in the multiplier slot. In
-  // addition to the available letters, options are limited by the dictionary,
-  // any letters already placed in the multiplier slots, and by
-  // `Parameters::tiles_for_multiplier_tiles`.
-  absl::flat_hash_set<std::string> OptionsForMultiplierTiles() const;
+  // Calls `visit` with every way to reserve letters for the empty cells of
+  // `RemainingMultiplierCells()`, drawn from the `num_tiles` most valuable
+  // free tiles (normally `Parameters::num_tiles_for_mult_cells`). As
+  // interchangeable cells score alike, each group's letters are only offered
+  // once, sorted, leaving their order to `ReserveCells()`. Every option is
+  // distinct, so none need to be collected to remove duplicates.
+  void OptionsForMultiplierTiles(
+      int num_tiles, absl::FunctionRef<void(absl::string_view)> visit) const;
 
   /** * * * **
    * Scoring *
    ** * * * **/
 
+  // Solver::ScoredLine
+  //
+  // What `lines_[i]` currently contributes to the score. Cached in
+  // `scored_lines_` until a cell in the line changes.
+  struct ScoredLine {
+    bool is_current = false;
+    std::string word;
+    bool is_common = false;
+    int score = 0;
+  };
+
+  // Solver::ScoreLine()
+  //
+  // Returns the cached `ScoredLine` for `lines_[i]`, computing it first if any
+  // of the line's cells have changed since it was last computed.
+  const ScoredLine &ScoreLine(int i) const;
+
+  // Solver::InvalidateLines()
+  //
+  // Marks the cached `ScoredLine` of every line passing through a cell in
+  // `cells` as out of date. Bit `5*row+col` of `cells` stands for that cell.
+  void InvalidateLines(uint32_t cells);
+
   // Solver::LineScore()
   //
-  // Gets the word from `line` and checks whether it is a valid word. If not,
-  // returns 0. If it is, calculates the score from the letters and multipliers,
-  // and multiplies by 1.3 if the word is a common word before returning.
-  int LineScore(const std::vector<Point> &line) const;
+  // Gets the word from `lines_[i]` and checks whether it is a valid word. If
+  // not, returns 0. If it is, calculates the score from the letters and
+  // multipliers, and multiplies by 1.3 if the word is a common word before
+  // returning.
+  int LineScore(int i) const { return ScoreLine(i).score; }
 
   // Solver::Score()
   //
   // Sums `LineScore` for the six lines to be used in scoring.
   int Score() const;
 
+  // Solver::UpperBound()
+  //
+  // Returns a score that no board reachable from `state_` can exceed. Full
+  // lines contribute their exact `LineScore`. Every other line is assumed to
+  // become a common word using all of its letters. Its empty cells are assumed
+  // to hold the most valuable unplaced tiles, with the best tiles on the cells
+  // that count most, i.e. multipliers and cells shared with the bonus line.
+  // Reserved cells are assumed to hold their reserved letters.
+  int UpperBound() const;
+
+  // Solver::CanBeatBestScore()
+  //
+  // Returns `false` if `UpperBound()` shows that searching on from `state_`
+  // cannot find a new best state. When searching in parallel, a branch is only
+  // cut by another worker's score if it cannot even tie it, so that the same
+  // board is found as in a serial search.
+  bool CanBeatBestScore() const;
+
+  /** * * * * * * * * * *
+   * Constraint tracking *
+   * * * * * * * * * * * **/
+
+  // Solver::CellLetterMasks()
+  //
+  // Returns, for each cell, a mask in which bit `c - 'a'` is set if the cell
+  // holds, or may still take, the letter `c`. An empty cell may take its
+  // reserved letters if it has any, and the free letters otherwise.
+  std::array<uint32_t, 25> CellLetterMasks() const;
+
+  // Solver::RebuildLineIds()
+  //
+  // Sets `line_ids_[i]` to the IDs of the words that `lines_[i]` could hold,
+  // given `CellLetterMasks()`, or to nothing if the line is full.
+  void RebuildLineIds();
+
+  // Solver::LineIds()
+  //
+  // Returns `line_ids_`, first bringing it up to date with any changes to
+  // `state_` or `reservations_` since `line_ids_masks_`. Masks only ever lose
+  // letters, so each lost letter just removes the words with it from the lines
+  // through that cell. This is done lazily, as most boards are cut by
+  // `CanBeatBestScore()` before their lines are needed.
+  const std::vector<Dict::WordBitset> &LineIds() const;
+
+  // Solver::IsFeasible()
+  //
+  // Returns `false` if no board reachable from `state_` can be complete. Each
+  // full line must already be a word. Each other line must either already
+  // score a word, as `IsComplete()` accepts, or still have a word in
+  // `line_ids_` that the letters left can fill, counting repeated letters. The
+  // letters that cells shared by two such lines may take are narrowed, until
+  // nothing changes, to those that such a word in each line would place there.
+  // A bonus word that no row can cross is thus caught before the rows are
+  // tried.
+  bool IsFeasible() const;
+
   // Solver::UpdateBestState()
   //
   // Checks `state_` against `best_state_`, updating `best_state_` and
-  // `best_score_` if the current state scores higher.
+  // `best_score_` if the current state scores higher. When searching in
+  // parallel, also raises `shared_best_score_`.
   void UpdateBestState();
 
   /** * * **
@@ -212,11 +561,11 @@ class Solver {
 
   // Solver::GetWord()
   //
-  // Returns the word that will be scored from the line in `state_`.
+  // Returns the word that will be scored from `lines_[i]` in `state_`.
   // Word must consist of 3+ consecutive letters (or 4 exactly if in the bonus
   // line) and be a valid word in `dict_`. If these conditions are failed,
   // returns an empty string.
-  std::string GetWord(const std::vector<Point> &line) const;
+  const std::string &GetWord(int i) const { return ScoreLine(i).word; }
 
   // Solver::IsComplete()
   //
@@ -233,16 +582,38 @@ class Solver {
    * Members *
    ** * * * **/
 
-  const Dict dict_;
+  // Shared, so that copies of the solver made for worker threads are cheap.
+  std::shared_ptr<const Dict> dict_;
   const std::vector<std::vector<Point>> lines_;
   const std::vector<Point> bonus_line_;
   const std::vector<Point> multiplier_points_;
   const Gamestate starting_state_;
-  int best_score_;
+  int best_score_ = 0;
   Gamestate best_state_;
   Gamestate state_;
-  std::vector<absl::flat_hash_set<Point>> locks_;
+  // The letters set aside for multiplier cells by `ReserveCells()`.
+  std::vector<Reservation> reservations_;
+  // One entry per `FillCells()` or `ReserveCells()` call not yet undone.
+  std::vector<Step> steps_;
   Parameters params_;
+
+  // The parameters before the latest widening, if `Solve()` has widened the
+  // search. Every board reachable under them has already been searched.
+  std::optional<Parameters> previous_params_;
+
+  // Bit `i` of `lines_through_cell_[5*row+col]` is set if `lines_[i]` passes
+  // through that cell.
+  std::array<uint8_t, 25> lines_through_cell_;
+  mutable std::vector<ScoredLine> scored_lines_;
+  // `line_ids_[i]` holds the IDs, in `dict_`, of the words that could still
+  // fill `lines_[i]`, or nothing once it is full, as of the cell masks
+  // `line_ids_masks_`. Use `LineIds()` for an up-to-date copy.
+  mutable std::vector<Dict::WordBitset> line_ids_;
+  mutable std::array<uint32_t, 25> line_ids_masks_;
+
+  // The best score found by any worker, when searching in parallel.
+  std::atomic<int> *shared_best_score_ = nullptr;
+  SearchCache *cache_ = nullptr;
 };
 
 }  // namespace puzzmo::bongo
@@ -1,17 +1,69 @@
 #include "solver.h"
 
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 namespace puzzmo::bongo {
+
+// Reaches into a `Solver` to test its constraint tracking directly.
+class SolverPeer {
+ public:
+  explicit SolverPeer(Solver &solver) : solver_(solver) {}
+
+  absl::Status FillCells(const std::vector<Point> &cells,
+                         absl::string_view letters) {
+    return solver_.FillCells(cells, letters);
+  }
+  absl::Status ClearCells() { return solver_.ClearCells(); }
+  bool IsFeasible() const { return solver_.IsFeasible(); }
+
+  // The line IDs as maintained incrementally, and as rebuilt from scratch.
+  std::vector<Dict::WordBitset> LineIds() const { return solver_.LineIds(); }
+  std::vector<Dict::WordBitset> RebuiltLineIds() const {
+    Solver copy = solver_;
+    copy.RebuildLineIds();
+    return copy.line_ids_;
+  }
+
+ private:
+  Solver &solver_;
+};
+
 namespace {
 
 using absl_testing::IsOk;
 using absl_testing::IsOkAndHolds;
 using absl_testing::StatusIs;
 
+const std::vector<std::string> kDummyBoard = {"*___2", "_*__2", "__*_3",
+                                              "___*_", "_____"};
+const absl::flat_hash_map<char, int> kLetterValues = {
+    {'a', 1}, {'e', 2}, {'r', 3}, {'s', 4}, {'t', 5}};
+
+// Every row can be filled with an anagram of "aerst", and several bonus words
+// can be made along the diagonal.
+Dict AnagramDict() {
+  return Dict({"aster", "rates", "stare", "tares", "tears", "rate", "sear",
+               "star", "tear"},
+              {"stare", "tears", "star"});
+}
+
+// An empty `kDummyBoard` holding five of each letter in "aerst".
+Gamestate DummyState() {
+  return Gamestate(kDummyBoard, kLetterValues,
+                   LetterCount("aaaaaeeeeerrrrrsssssttttt"));
+}
+
 TEST(SolverTest, Constructor) {
   //
 }
@@ -61,5 +113,144 @@ TEST(SolverTest, MostRestrictedWordlessRow) {
   // EXPECT_EQ(bgs.MostRestrictedWordlessRow(), 3);
 }
 
+TEST(SolverTest, LineIdsMatchRebuild) {
+  Solver solver(AnagramDict(), DummyState(), {});
+  SolverPeer peer(solver);
+  ASSERT_THAT(peer.FillCells({{0, 0}, {0, 1}, {0, 2}, {0, 3}, {0, 4}}, "stare"),
+              IsOk());
+  EXPECT_EQ(peer.LineIds(), peer.RebuiltLineIds());
+  ASSERT_THAT(peer.FillCells({{1, 1}, {2, 2}}, "ea"), IsOk());
+  EXPECT_EQ(peer.LineIds(), peer.RebuiltLineIds());
+  ASSERT_THAT(peer.ClearCells(), IsOk());
+  EXPECT_EQ(peer.LineIds(), peer.RebuiltLineIds());
+  ASSERT_THAT(peer.ClearCells(), IsOk());
+  EXPECT_EQ(peer.LineIds(), peer.RebuiltLineIds());
+}
+
+TEST(SolverTest, IsFeasible) {
+  Solver solver(AnagramDict(), DummyState(), {});
+  SolverPeer peer(solver);
+  EXPECT_TRUE(peer.IsFeasible());
+
+  // No word starts with "aa", so the first row can never score.
+  ASSERT_THAT(peer.FillCells({{0, 0}, {0, 1}}, "aa"), IsOk());
+  EXPECT_FALSE(peer.IsFeasible());
+  ASSERT_THAT(peer.ClearCells(), IsOk());
+
+  // No five-letter word ends in "rate", but the row already scores "rate".
+  ASSERT_THAT(peer.FillCells({{0, 1}, {0, 2}, {0, 3}, {0, 4}}, "rate"), IsOk());
+  EXPECT_TRUE(peer.IsFeasible());
+}
+
+TEST(SolverTest, BranchAndBoundKeepsOptimum) {
+  Solver solver(AnagramDict(), DummyState(), {});
+  ASSERT_THAT(solver.Solve(), IsOk());
+  // Found by exhaustive search: "tear" along the diagonal, with common words
+  // on the multipliers.
+  EXPECT_EQ(solver.best_score(), 131);
+}
+
+TEST(SolverTest, ParallelMatchesSerial) {
+  Solver serial(AnagramDict(), DummyState(), {});
+  absl::StatusOr<Gamestate> expected = serial.Solve();
+  ASSERT_THAT(expected, IsOk());
+  EXPECT_GT(serial.best_score(), 0);
+
+  for (int num_threads : {2, 4}) {
+    for (int parallel_depth : {1, 2}) {
+      Solver parallel(AnagramDict(), DummyState(),
+                      {.num_threads = num_threads,
+                       .parallel_depth = parallel_depth});
+      EXPECT_THAT(parallel.Solve(), IsOkAndHolds(*expected));
+      EXPECT_EQ(parallel.best_score(), serial.best_score());
+    }
+  }
+}
+
+TEST(SolverTest, CacheMatchesUncached) {
+  Solver uncached(AnagramDict(), DummyState(), {});
+  absl::StatusOr<Gamestate> expected = uncached.Solve();
+  ASSERT_THAT(expected, IsOk());
+
+  const std::string path = testing::TempDir() + "solver_test.cache";
+  std::remove(path.c_str());
+  absl::StatusOr<std::unique_ptr<SearchCache>> cache = SearchCache::Open(path);
+  ASSERT_THAT(cache, IsOk());
+
+  // The first run fills the cache, and the second is answered from it.
+  for (int run = 0; run < 2; ++run) {
+    Solver cached(AnagramDict(), DummyState(), {});
+    cached.set_cache(cache->get());
+    EXPECT_THAT(cached.Solve(), IsOkAndHolds(*expected));
+    EXPECT_EQ(cached.best_score(), uncached.best_score());
+    EXPECT_GT((*cache)->size(), 0);
+  }
+
+  // Only tasks that found a scoring board record it as their answer.
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    const std::vector<std::string> fields = absl::StrSplit(line, '\t');
+    ASSERT_EQ(fields.size(), 5);
+    if (fields[2] == "1") {
+      EXPECT_NE(fields[1], "0") << line;
+      EXPECT_EQ(fields[3].size(), 25) << line;
+    }
+  }
+}
+
+TEST(SolverTest, WideningMatchesWideSearch) {
+  Solver wide(AnagramDict(), DummyState(),
+              {.num_tiles_for_bonus_words = 4, .num_tiles_for_mult_cells = 4});
+  ASSERT_THAT(wide.Solve(), IsOk());
+  EXPECT_GT(wide.best_score(), 0);
+
+  // Each round only searches boards that the previous rounds could not reach,
+  // so the best board across rounds is the best board overall.
+  for (const int num_threads : {1, 2}) {
+    Solver widening(AnagramDict(), DummyState(),
+                    {.num_tiles_for_bonus_words = 1,
+                     .num_tiles_for_mult_cells = 1,
+                     .num_threads = num_threads,
+                     .widening_rounds = 3});
+    ASSERT_THAT(widening.Solve(), IsOk());
+    EXPECT_EQ(widening.best_score(), wide.best_score());
+  }
+}
+
+TEST(SolverTest, MultiplierReservationsKeepOptimum) {
+  Solver rows_only(AnagramDict(), DummyState(), {.techniques = {}});
+  ASSERT_THAT(rows_only.Solve(), IsOk());
+
+  // The two 2x cells are interchangeable, so their letters are reserved and
+  // placed by the row words that cross them.
+  for (const std::vector<Technique> &techniques :
+       std::vector<std::vector<Technique>>{
+           {Technique::kFillMultiplierCells},
+           {Technique::kFillMultiplierCells, Technique::kFillBonusWordCells},
+           {Technique::kFillBonusWordCells, Technique::kFillMultiplierCells}}) {
+    Solver solver(AnagramDict(), DummyState(),
+                  {.techniques = techniques,
+                   .num_tiles_for_bonus_words = 25,
+                   .num_tiles_for_mult_cells = 25});
+    ASSERT_THAT(solver.Solve(), IsOk());
+    EXPECT_EQ(solver.best_score(), rows_only.best_score());
+  }
+}
+
+TEST(SolverTest, BestFirstMatchesDepthFirst) {
+  Solver depth_first(AnagramDict(), DummyState(), {});
+  ASSERT_THAT(depth_first.Solve(), IsOk());
+
+  // A tiny queue hands most of the search back to the depth-first helper.
+  for (const int max_queued_states : {1, 2, 1 << 20}) {
+    Solver best_first(AnagramDict(), DummyState(),
+                      {.best_first = true,
+                       .max_queued_states = max_queued_states});
+    ASSERT_THAT(best_first.Solve(), IsOk());
+    EXPECT_EQ(best_first.best_score(), depth_first.best_score());
+  }
+}
+
 }  // namespace
-}  // namespace puzzmo::bongo
\ No newline at end of file
+}  // namespace puzzmo::bongo
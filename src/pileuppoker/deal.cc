@@ -0,0 +1,29 @@
+#include "deal.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+namespace puzzmo {
+namespace {
+
+constexpr absl::string_view kWrongNumberOfCardsError =
+    "Pile-Up Poker needs exactly 20 cards.";
+constexpr absl::string_view kDuplicateCardError =
+    "The same card cannot be dealt twice.";
+
+}  // namespace
+
+absl::Status ValidateDeal(const std::vector<Card> &cards, bool complete) {
+  if (complete && cards.size() != kDealSize)
+    return absl::InvalidArgumentError(kWrongNumberOfCardsError);
+  std::vector<Card> sorted = cards;
+  std::sort(sorted.begin(), sorted.end());
+  if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+    return absl::InvalidArgumentError(kDuplicateCardError);
+  return absl::OkStatus();
+}
+
+}  // namespace puzzmo
@@ -0,0 +1,33 @@
+// -----------------------------------------------------------------------------
+// File: deal.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines the checks that every Pile-Up Poker solver makes on
+// the cards it is given before searching.
+
+#ifndef PUZZMO_PILEUPPOKER_DEAL_H_
+#define PUZZMO_PILEUPPOKER_DEAL_H_
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "src/pileuppoker/card.h"
+
+namespace puzzmo {
+
+// The number of cards dealt in a game of Pile-Up Poker: 16 for the grid and 4
+// discards.
+constexpr int kDealSize = 20;
+
+// ValidateDeal()
+//
+// Returns an error if any card appears twice in `cards`, or, if `complete` is
+// true, if `cards` does not hold exactly `kDealSize` cards. Pass `false` to
+// check cards that are not a whole deal, such as those seen so far along with
+// those still to be drawn.
+absl::Status ValidateDeal(const std::vector<Card> &cards,
+                          bool complete = true);
+
+}  // namespace puzzmo
+
+#endif
@@ -0,0 +1,35 @@
+#include "deal.h"
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "src/pileuppoker/test_cards.h"
+
+namespace puzzmo {
+namespace {
+
+using absl_testing::IsOk;
+using absl_testing::StatusIs;
+
+TEST(DealTest, ValidateDeal) {
+  EXPECT_THAT(ValidateDeal(TestDeal()), IsOk());
+
+  std::vector<Card> short_deal = TestDeal();
+  short_deal.pop_back();
+  EXPECT_THAT(ValidateDeal(short_deal),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ValidateDeal(short_deal, /*complete=*/false), IsOk());
+
+  std::vector<Card> repeated_deal = TestDeal();
+  repeated_deal.back() = repeated_deal.front();
+  EXPECT_THAT(ValidateDeal(repeated_deal),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ValidateDeal(Cards({"2S", "3H", "2S"}), /*complete=*/false),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace puzzmo
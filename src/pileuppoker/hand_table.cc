@@ -0,0 +1,86 @@
+#include "hand_table.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace puzzmo {
+namespace {
+
+constexpr int kNumCards = 52;
+
+// `kChoose[n][k]` is n choose k, for the combinatorial rank in `Index()`.
+constexpr std::array<std::array<int, 5>, kNumCards + 1> kChoose = [] {
+  std::array<std::array<int, 5>, kNumCards + 1> choose = {};
+  for (int n = 0; n <= kNumCards; ++n) {
+    choose[n][0] = 1;
+    for (int k = 1; k <= 4 && k <= n; ++k)
+      choose[n][k] = choose[n - 1][k - 1] + choose[n - 1][k];
+  }
+  return choose;
+}();
+
+// Numbers the cards from 0 to 51.
+int CardId(const Card &card) { return 4 * (card.rank - kTwo) + card.suit; }
+
+Card CardWithId(int id) {
+  return {.rank = static_cast<Rank>(id / 4 + kTwo),
+          .suit = static_cast<Suit>(id % 4)};
+}
+
+// Scores a hand the slow way, for filling in the table.
+int ScoreHand(const Card &c1, const Card &c2, const Card &c3, const Card &c4) {
+  std::array<Card, 4> hand = {c1, c2, c3, c4};
+  std::sort(hand.begin(), hand.end());
+
+  bool flush = (c1.suit == c2.suit && c2.suit == c3.suit && c3.suit == c4.suit);
+  bool straight =
+      (hand[1].rank - hand[0].rank == 1 && hand[2].rank - hand[1].rank == 1 &&
+       hand[3].rank - hand[2].rank == 1);
+  if (straight && flush) return kStraightFlush;
+  if (straight) return kStraight;
+  if (flush) return kFlush;
+  if (hand[0].rank == hand[3].rank) return kFourOfAKind;
+  if (hand[0].rank == hand[2].rank || hand[1].rank == hand[3].rank)
+    return kThreeOfAKind;
+  if (hand[0].rank == hand[1].rank && hand[2].rank == hand[3].rank)
+    return kTwoPair;
+  if (hand[0].rank == hand[1].rank || hand[1].rank == hand[2].rank ||
+      hand[2].rank == hand[3].rank)
+    return kPair;
+  return 0;  // Non-scoring
+}
+
+}  // namespace
+
+const HandTable &HandTable::Get() {
+  static const HandTable *table = new HandTable();
+  return *table;
+}
+
+int HandTable::Index(const Card &c1, const Card &c2, const Card &c3,
+                     const Card &c4) {
+  int a = CardId(c1), b = CardId(c2), c = CardId(c3), d = CardId(c4);
+  if (a > b) std::swap(a, b);
+  if (c > d) std::swap(c, d);
+  if (a > c) std::swap(a, c);
+  if (b > d) std::swap(b, d);
+  if (b > c) std::swap(b, c);
+  return kChoose[a][1] + kChoose[b][2] + kChoose[c][3] + kChoose[d][4];
+}
+
+HandTable::HandTable() : scores_(kNumHands) {
+  for (int d = 3; d < kNumCards; ++d) {
+    for (int c = 2; c < d; ++c) {
+      for (int b = 1; b < c; ++b) {
+        for (int a = 0; a < b; ++a) {
+          const Card c1 = CardWithId(a), c2 = CardWithId(b),
+                     c3 = CardWithId(c), c4 = CardWithId(d);
+          scores_[Index(c1, c2, c3, c4)] = ScoreHand(c1, c2, c3, c4);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace puzzmo
@@ -0,0 +1,76 @@
+// -----------------------------------------------------------------------------
+// File: hand_table.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines a lookup table holding the Pile-Up Poker score of
+// every 4-card hand, so that scoring a hand costs a sort of four small integers
+// and one load.
+
+#ifndef PUZZMO_PILEUPPOKER_HAND_TABLE_H_
+#define PUZZMO_PILEUPPOKER_HAND_TABLE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "src/pileuppoker/card.h"
+
+namespace puzzmo {
+
+// The score of each kind of hand, from best to worst.
+inline constexpr int kStraightFlush = 450;
+inline constexpr int kFourOfAKind = 325;
+inline constexpr int kStraight = 180;
+inline constexpr int kThreeOfAKind = 125;
+inline constexpr int kFlush = 80;
+inline constexpr int kTwoPair = 60;
+inline constexpr int kPair = 5;
+
+// HandTable
+//
+// Holds the score of each of the C(52, 4) = 270725 hands, indexed by the
+// combinatorial rank of their cards. The table is built once, on first use, and
+// shared by every caller.
+class HandTable {
+ public:
+  static constexpr int kNumHands = 270725;
+
+  // HandTable::Get()
+  //
+  // Returns the process-wide table.
+  static const HandTable &Get();
+
+  // HandTable::Index()
+  //
+  // Returns the position of a hand in the table, in [0, `kNumHands`). The order
+  // of the cards does not matter, but they must be distinct.
+  static int Index(const Card &c1, const Card &c2, const Card &c3,
+                   const Card &c4);
+
+  // HandTable::Score()
+  //
+  // Returns the score of a hand, or 0 if it is non-scoring.
+  int Score(int index) const { return scores_[index]; }
+  int Score(const Card &c1, const Card &c2, const Card &c3,
+            const Card &c4) const {
+    return Score(Index(c1, c2, c3, c4));
+  }
+
+  // HandTable::IsScoring()
+  //
+  // Returns whether a hand scores at all. The discards only count if every
+  // other hand on the board does.
+  bool IsScoring(int index) const { return scores_[index] != 0; }
+  bool IsScoring(const Card &c1, const Card &c2, const Card &c3,
+                 const Card &c4) const {
+    return IsScoring(Index(c1, c2, c3, c4));
+  }
+
+ private:
+  HandTable();
+
+  std::vector<uint16_t> scores_;
+};
+
+}  // namespace puzzmo
+
+#endif
@@ -0,0 +1,85 @@
+#include "hand_table.h"
+
+#include <map>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "src/pileuppoker/test_cards.h"
+
+namespace puzzmo {
+namespace {
+
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+TEST(HandTableTest, IndexIsAPerfectHash) {
+  const std::vector<Card> cards = AllCards();
+  std::vector<bool> seen(HandTable::kNumHands, false);
+  for (int a = 0; a < cards.size(); ++a) {
+    for (int b = a + 1; b < cards.size(); ++b) {
+      for (int c = b + 1; c < cards.size(); ++c) {
+        for (int d = c + 1; d < cards.size(); ++d) {
+          const int index =
+              HandTable::Index(cards[a], cards[b], cards[c], cards[d]);
+          ASSERT_GE(index, 0);
+          ASSERT_LT(index, HandTable::kNumHands);
+          EXPECT_FALSE(seen[index]);
+          seen[index] = true;
+          EXPECT_EQ(HandTable::Index(cards[d], cards[b], cards[a], cards[c]),
+                    index);
+        }
+      }
+    }
+  }
+}
+
+TEST(HandTableTest, Score) {
+  const HandTable &table = HandTable::Get();
+  EXPECT_EQ(table.Score({kJack, kClubs}, {kAce, kClubs}, {kQueen, kClubs},
+                        {kKing, kClubs}),
+            kStraightFlush);
+  EXPECT_EQ(table.Score({kEight, kHearts}, {kEight, kClubs},
+                        {kEight, kDiamonds}, {kEight, kSpades}),
+            kFourOfAKind);
+  EXPECT_EQ(table.Score({kSix, kHearts}, {kSeven, kHearts}, {kNine, kClubs},
+                        {kEight, kDiamonds}),
+            kStraight);
+  EXPECT_EQ(table.Score({kSix, kHearts}, {kSix, kClubs}, {kSix, kDiamonds},
+                        {kJack, kHearts}),
+            kThreeOfAKind);
+  EXPECT_EQ(table.Score({kTen, kDiamonds}, {kNine, kDiamonds},
+                        {kSix, kDiamonds}, {kKing, kDiamonds}),
+            kFlush);
+  EXPECT_EQ(table.Score({kAce, kClubs}, {kKing, kDiamonds}, {kAce, kHearts},
+                        {kKing, kClubs}),
+            kTwoPair);
+  EXPECT_EQ(table.Score({kNine, kClubs}, {kNine, kDiamonds}, {kSeven, kHearts},
+                        {kTen, kSpades}),
+            kPair);
+
+  // Aces are only high.
+  EXPECT_EQ(table.Score({kAce, kClubs}, {kTwo, kDiamonds}, {kThree, kHearts},
+                        {kFour, kSpades}),
+            0);
+  EXPECT_FALSE(table.IsScoring({kAce, kClubs}, {kTwo, kDiamonds},
+                               {kThree, kHearts}, {kFour, kSpades}));
+  EXPECT_TRUE(table.IsScoring({kNine, kClubs}, {kNine, kDiamonds},
+                              {kSeven, kHearts}, {kTen, kSpades}));
+}
+
+TEST(HandTableTest, CountsEachKindOfHand) {
+  const HandTable &table = HandTable::Get();
+  std::map<int, int> counts;
+  for (int i = 0; i < HandTable::kNumHands; ++i) ++counts[table.Score(i)];
+  EXPECT_THAT(counts, UnorderedElementsAre(
+                          Pair(kStraightFlush, 10 * 4),
+                          Pair(kFourOfAKind, 13), Pair(kStraight, 10 * 252),
+                          Pair(kThreeOfAKind, 13 * 4 * 48),
+                          Pair(kFlush, 4 * (715 - 10)),
+                          Pair(kTwoPair, 78 * 6 * 6),
+                          Pair(kPair, 13 * 6 * 66 * 16), Pair(0, 177660)));
+}
+
+}  // namespace
+}  // namespace puzzmo
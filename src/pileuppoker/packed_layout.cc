@@ -0,0 +1,63 @@
+#include "packed_layout.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace puzzmo {
+namespace {
+
+// One byte per line, with the lines past `kNumLines` left as padding so that
+// each lane fills a vector register.
+constexpr int kNumLanes = 16;
+
+// `kLaneSpots[i][line]` is the spot of the `i`th card of `line`. Padding lines
+// read spot 0.
+constexpr std::array<std::array<int, kNumLanes>, 4> kLaneSpots = [] {
+  std::array<std::array<int, kNumLanes>, 4> spots = {};
+  for (int i = 0; i < 4; ++i) {
+    for (int line = 0; line < kNumLines; ++line)
+      spots[i][line] = kLayoutLines[line][i];
+  }
+  return spots;
+}();
+
+}  // namespace
+
+PackedLayout PackLayout(const std::vector<Card> &layout) {
+  PackedLayout packed;
+  for (int i = 0; i < packed.size(); ++i) packed[i] = PackCard(layout[i]);
+  return packed;
+}
+
+std::array<int, kNumLines> ScoreLines(const PackedLayout &layout) {
+  std::array<std::array<PackedCard, kNumLanes>, 4> lanes;
+  for (int i = 0; i < 4; ++i) {
+    for (int line = 0; line < kNumLanes; ++line)
+      lanes[i][line] = layout[kLaneSpots[i][line]];
+  }
+  std::array<uint8_t, kNumLanes> shapes;
+  for (int line = 0; line < kNumLanes; ++line) {
+    shapes[line] = PackedHandShape(lanes[0][line], lanes[1][line],
+                                   lanes[2][line], lanes[3][line]);
+  }
+  std::array<int, kNumLines> scores;
+  for (int line = 0; line < kNumLines; ++line)
+    scores[line] = kHandShapeScores[shapes[line]];
+  return scores;
+}
+
+int ScoreLayout(const PackedLayout &layout) {
+  const std::array<int, kNumLines> scores = ScoreLines(layout);
+  int score = 0;
+  bool count_discard = true;
+  for (int line = 0; line < kDiscardLine; ++line) {
+    score += kLineMultipliers[line] * scores[line];
+    count_discard &= scores[line] != 0;
+  }
+  if (count_discard)
+    score += kLineMultipliers[kDiscardLine] * scores[kDiscardLine];
+  return score;
+}
+
+}  // namespace puzzmo
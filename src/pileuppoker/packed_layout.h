@@ -0,0 +1,121 @@
+// -----------------------------------------------------------------------------
+// File: packed_layout.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines a compact encoding of Pile-Up Poker cards and
+// layouts, one byte per card, and scoring routines that work on it directly.
+// They are meant for code that scores many layouts, such as local search.
+
+#ifndef PUZZMO_PILEUPPOKER_PACKED_LAYOUT_H_
+#define PUZZMO_PILEUPPOKER_PACKED_LAYOUT_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "src/pileuppoker/card.h"
+#include "src/pileuppoker/hand_table.h"
+
+namespace puzzmo {
+
+// A card in one byte: its rank in the high six bits and its suit in the low
+// two, so that packed cards sort as `Card`s do.
+using PackedCard = uint8_t;
+
+// A layout of 20 packed cards, indexed as for `PileupPokerSolver`.
+using PackedLayout = std::array<PackedCard, 20>;
+
+// The spots in each row, then each column, then the corners, then the
+// discards, and what each line's hand is multiplied by. The discards only
+// count if every other line scores.
+inline constexpr int kNumLines = 10;
+inline constexpr int kDiscardLine = 9;
+inline constexpr std::array<std::array<int, 4>, kNumLines> kLayoutLines = {
+    {{0, 1, 2, 3},
+     {4, 5, 6, 7},
+     {8, 9, 10, 11},
+     {12, 13, 14, 15},
+     {0, 4, 8, 12},
+     {1, 5, 9, 13},
+     {2, 6, 10, 14},
+     {3, 7, 11, 15},
+     {0, 3, 12, 15},
+     {16, 17, 18, 19}}};
+inline constexpr std::array<int, kNumLines> kLineMultipliers = {
+    1, 1, 1, 1, 1, 1, 1, 1, 2, 3};
+
+// The lines through each spot, ended by -1 if there are fewer than three.
+inline constexpr std::array<std::array<int, 3>, 20> kSpotLines = [] {
+  std::array<std::array<int, 3>, 20> lines;
+  for (auto &spot_lines : lines) spot_lines.fill(-1);
+  for (int line = 0; line < kNumLines; ++line) {
+    for (int spot : kLayoutLines[line]) {
+      int i = 0;
+      while (lines[spot][i] >= 0) ++i;
+      lines[spot][i] = line;
+    }
+  }
+  return lines;
+}();
+
+inline PackedCard PackCard(const Card &card) {
+  return static_cast<PackedCard>(card.rank << 2 | card.suit);
+}
+
+inline Card UnpackCard(PackedCard card) {
+  return {.rank = static_cast<Rank>(card >> 2),
+          .suit = static_cast<Suit>(card & 3)};
+}
+
+// puzzmo::PackLayout()
+//
+// Packs the first 20 cards of `layout`.
+PackedLayout PackLayout(const std::vector<Card> &layout);
+
+// puzzmo::PackedHandShape()
+//
+// Classifies a hand of four distinct cards without branching. The number of
+// equal pairs of ranks tells the hands with repeated ranks apart, and a hand
+// with none is a straight if its ranks span four, and a flush if its suits all
+// match. The shape is the number of equal pairs, plus 7 for a straight and 8
+// for a flush, and `kHandShapeScores` holds the score of each.
+inline uint8_t PackedHandShape(PackedCard a, PackedCard b, PackedCard c,
+                               PackedCard d) {
+  const uint8_t ra = a >> 2, rb = b >> 2, rc = c >> 2, rd = d >> 2;
+  const uint8_t pairs = (ra == rb) + (ra == rc) + (ra == rd) + (rb == rc) +
+                        (rb == rd) + (rc == rd);
+  const uint8_t span = std::max(std::max(ra, rb), std::max(rc, rd)) -
+                       std::min(std::min(ra, rb), std::min(rc, rd));
+  const uint8_t straight = (pairs == 0) & (span == 3);
+  const uint8_t flush = (((a ^ b) | (a ^ c) | (a ^ d)) & 3) == 0;
+  return pairs + 7 * straight + 8 * flush;
+}
+
+inline constexpr std::array<int, 16> kHandShapeScores = {
+    0,      kPair, kTwoPair, kThreeOfAKind, 0, 0, kFourOfAKind, kStraight,
+    kFlush, 0,     0,        0,             0, 0, 0,            kStraightFlush};
+
+// puzzmo::ScorePackedHand()
+//
+// Scores a hand of four distinct cards without lookups into `HandTable`.
+inline int ScorePackedHand(PackedCard a, PackedCard b, PackedCard c,
+                           PackedCard d) {
+  return kHandShapeScores[PackedHandShape(a, b, c, d)];
+}
+
+// puzzmo::ScoreLines()
+//
+// Returns the unmultiplied score of each line of `layout`. The lines' cards
+// are gathered into four 16-byte lanes first, one line per byte, so that the
+// compiler can classify every line at once with a few vector instructions.
+std::array<int, kNumLines> ScoreLines(const PackedLayout &layout);
+
+// puzzmo::ScoreLayout()
+//
+// Scores a full layout, as `PileupPokerSolver::Score()` does.
+int ScoreLayout(const PackedLayout &layout);
+
+}  // namespace puzzmo
+
+#endif
@@ -0,0 +1,55 @@
+#include "packed_layout.h"
+
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "src/pileuppoker/hand_table.h"
+#include "src/pileuppoker/test_cards.h"
+
+namespace puzzmo {
+namespace {
+
+TEST(PackedLayoutTest, PackCard) {
+  const std::vector<Card> cards = AllCards();
+  for (int i = 0; i < cards.size(); ++i) {
+    EXPECT_EQ(UnpackCard(PackCard(cards[i])), cards[i]);
+    if (i > 0) {
+      EXPECT_LT(PackCard(cards[i - 1]), PackCard(cards[i]));
+    }
+  }
+}
+
+TEST(PackedLayoutTest, ScorePackedHandMatchesHandTable) {
+  const HandTable &table = HandTable::Get();
+  const std::vector<Card> cards = AllCards();
+  for (int a = 0; a < cards.size(); ++a) {
+    for (int b = a + 1; b < cards.size(); ++b) {
+      for (int c = b + 1; c < cards.size(); ++c) {
+        for (int d = c + 1; d < cards.size(); ++d) {
+          ASSERT_EQ(ScorePackedHand(PackCard(cards[a]), PackCard(cards[b]),
+                                    PackCard(cards[c]), PackCard(cards[d])),
+                    table.Score(cards[a], cards[b], cards[c], cards[d]));
+        }
+      }
+    }
+  }
+}
+
+TEST(PackedLayoutTest, ScoreLayout) {
+  PackedLayout layout = PackLayout(BestTestLayout());
+  EXPECT_THAT(ScoreLines(layout),
+              testing::ElementsAre(kFlush, kFlush, kFlush, kStraight,
+                                   kStraight, kPair, kThreeOfAKind, kTwoPair,
+                                   kStraightFlush, kFourOfAKind));
+  EXPECT_EQ(ScoreLayout(layout), 2665);
+
+  // Swapping the 7 and the jack spoils the first and third rows, the first
+  // column and the corners, so the discards no longer count either.
+  std::swap(layout[0], layout[9]);
+  EXPECT_EQ(ScoreLayout(layout), 80 + 180 + 5 + 125 + 60);
+}
+
+}  // namespace
+}  // namespace puzzmo
@@ -0,0 +1,214 @@
+#include "pile_up_poker_advisor.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "src/pileuppoker/deal.h"
+#include "src/pileuppoker/hand_table.h"
+#include "src/pileuppoker/packed_layout.h"
+
+namespace puzzmo {
+namespace {
+
+constexpr absl::string_view kWrongNumberOfSpotsError =
+    "A Pile-Up Poker layout has exactly 20 spots.";
+constexpr absl::string_view kFullLayoutError =
+    "There is no empty spot left for the card.";
+constexpr absl::string_view kDeckTooSmallError =
+    "The deck does not hold enough cards to fill the layout.";
+
+constexpr int kNumSpots = 20;
+constexpr uint32_t kAllSpots = (1 << kNumSpots) - 1;
+
+// What `Outlook()` discounts a line by for each card it is missing: roughly
+// the chance that a random card keeps its best hand alive.
+constexpr std::array<double, 5> kOutlookDiscounts = {
+    1.0 / 256, 1.0 / 64, 1.0 / 16, 1.0 / 4, 1.0};
+
+}  // namespace
+
+/** * * * * * * * * * * *
+ * Public class methods *
+ ** * * * * * * * * * * */
+
+absl::StatusOr<PileupPokerAdvisor::Advice> PileupPokerAdvisor::Advise(
+    const std::vector<std::optional<Card>> &layout, const Card &card,
+    const std::vector<Card> &deck) {
+  if (layout.size() != kNumSpots)
+    return absl::InvalidArgumentError(kWrongNumberOfSpotsError);
+  PackedLayout board;
+  uint32_t filled = 0;
+  std::vector<Card> seen = deck;
+  seen.push_back(card);
+  for (int spot = 0; spot < kNumSpots; ++spot) {
+    if (!layout[spot].has_value()) continue;
+    board[spot] = PackCard(*layout[spot]);
+    filled |= 1 << spot;
+    seen.push_back(*layout[spot]);
+  }
+  if (absl::Status s = ValidateDeal(seen, /*complete=*/false); !s.ok())
+    return s;
+  if (filled == kAllSpots) return absl::InvalidArgumentError(kFullLayoutError);
+  const int draws = kNumSpots - 1 - std::popcount(filled);
+  if (deck.size() < draws)
+    return absl::InvalidArgumentError(kDeckTooSmallError);
+  deck_.clear();
+  for (const Card &c : deck) deck_.push_back(PackCard(c));
+  const PackedCard packed = PackCard(card);
+
+  std::vector<int> spots;
+  for (int spot = 0; spot < kNumSpots; ++spot) {
+    if (!(filled & (1 << spot))) spots.push_back(spot);
+  }
+
+  // With few enough draws left, every way they could go can be tried.
+  if (draws <= params_.max_exact_draws) {
+    Advice advice = {.spot = -1,
+                     .expected_score = -1,
+                     .exact = true,
+                     .rollouts = 0};
+    for (int spot : spots) {
+      board[spot] = packed;
+      const double expected = ExpectedScore(board, filled | (1 << spot), 0);
+      if (expected > advice.expected_score) {
+        advice.spot = spot;
+        advice.expected_score = expected;
+      }
+    }
+    return advice;
+  }
+
+  // Otherwise, play out the same sampled draws from every spot, so that the
+  // spots are compared on equal terms.
+  const absl::Time start = absl::Now();
+  std::vector<double> totals(spots.size(), 0);
+  std::vector<PackedCard> draw_order = deck_;
+  int rollouts = 0;
+  while (rollouts < params_.max_rollouts) {
+    for (int i = 0; i < draws; ++i) {
+      std::uniform_int_distribution<int> pick(i, draw_order.size() - 1);
+      std::swap(draw_order[i], draw_order[pick(rng_)]);
+    }
+    const std::vector<PackedCard> sample(draw_order.begin(),
+                                         draw_order.begin() + draws);
+    for (int i = 0; i < spots.size(); ++i) {
+      board[spots[i]] = packed;
+      totals[i] += Rollout(board, filled | (1 << spots[i]), sample);
+    }
+    ++rollouts;
+    if (absl::Now() - start >= params_.time_budget) break;
+  }
+
+  const int best = std::max_element(totals.begin(), totals.end()) -
+                   totals.begin();
+  return Advice{.spot = spots[best],
+                .expected_score = totals[best] / rollouts,
+                .exact = false,
+                .rollouts = rollouts};
+}
+
+/** * * * * * * * * *
+ * Private helpers *
+ ** * * * * * * * * */
+
+double PileupPokerAdvisor::ExpectedScore(PackedLayout &layout,
+                                         uint32_t filled,
+                                         uint64_t drawn) const {
+  if (filled == kAllSpots) return ScoreLayout(layout);
+
+  double total = 0;
+  int num_cards = 0;
+  for (int i = 0; i < deck_.size(); ++i) {
+    if (drawn & (uint64_t{1} << i)) continue;
+    double best = std::numeric_limits<double>::lowest();
+    for (uint32_t left = kAllSpots & ~filled; left != 0; left &= left - 1) {
+      const int spot = std::countr_zero(left);
+      layout[spot] = deck_[i];
+      best = std::max(best, ExpectedScore(layout, filled | (1 << spot),
+                                          drawn | (uint64_t{1} << i)));
+    }
+    total += best;
+    ++num_cards;
+  }
+  return total / num_cards;
+}
+
+int PileupPokerAdvisor::Rollout(PackedLayout layout, uint32_t filled,
+                                const std::vector<PackedCard> &draws) const {
+  for (const PackedCard card : draws) {
+    // Place the card wherever it most improves the outlook of its lines. Ties
+    // go to the lowest spot.
+    int best_spot = -1;
+    double best_gain = std::numeric_limits<double>::lowest();
+    for (uint32_t left = kAllSpots & ~filled; left != 0; left &= left - 1) {
+      const int spot = std::countr_zero(left);
+      double gain = 0;
+      for (int line : kSpotLines[spot]) {
+        if (line < 0) break;
+        gain -= kLineMultipliers[line] *
+                Outlook(layout, filled, kLayoutLines[line]);
+      }
+      layout[spot] = card;
+      for (int line : kSpotLines[spot]) {
+        if (line < 0) break;
+        gain += kLineMultipliers[line] *
+                Outlook(layout, filled | (1 << spot), kLayoutLines[line]);
+      }
+      if (gain > best_gain) {
+        best_gain = gain;
+        best_spot = spot;
+      }
+    }
+    layout[best_spot] = card;
+    filled |= 1 << best_spot;
+  }
+  return ScoreLayout(layout);
+}
+
+double PileupPokerAdvisor::Outlook(const PackedLayout &layout,
+                                   uint32_t filled,
+                                   const std::array<int, 4> &cells) {
+  std::array<int, 14> ranks = {};
+  int placed = 0, max_count = 0, distinct = 0, suit_bits = 0;
+  int low = kAce, high = kTwo;
+  for (int spot : cells) {
+    if (!(filled & (1 << spot))) continue;
+    const int rank = layout[spot] >> 2;
+    ++placed;
+    if (ranks[rank]++ == 0) ++distinct;
+    max_count = std::max(max_count, ranks[rank]);
+    suit_bits |= 1 << (layout[spot] & 3);
+    low = std::min(low, rank);
+    high = std::max(high, rank);
+  }
+  if (placed == 4) {
+    return ScorePackedHand(layout[cells[0]], layout[cells[1]],
+                           layout[cells[2]], layout[cells[3]]);
+  }
+
+  const bool suited = std::popcount(static_cast<unsigned>(suit_bits)) <= 1;
+  const bool straight = max_count <= 1 && (placed == 0 || high - low <= 3);
+  int hand = kPair;
+  if (suited && straight) {
+    hand = kStraightFlush;
+  } else if (distinct <= 1) {
+    hand = kFourOfAKind;
+  } else if (straight) {
+    hand = kStraight;
+  } else if (placed - max_count <= 1) {
+    hand = kThreeOfAKind;
+  } else if (suited) {
+    hand = kFlush;
+  } else if (distinct <= 2) {
+    hand = kTwoPair;
+  }
+  return hand * kOutlookDiscounts[placed];
+}
+
+}  // namespace puzzmo
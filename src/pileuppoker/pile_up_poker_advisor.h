@@ -0,0 +1,118 @@
+// -----------------------------------------------------------------------------
+// File: pile_up_poker_advisor.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines an advisor for playing Pile-Up Poker as the cards
+// are dealt, when each card must be placed before the next one is seen.
+
+#ifndef PUZZMO_PILEUPPOKER_PILEUPPOKERADVISOR_H_
+#define PUZZMO_PILEUPPOKER_PILEUPPOKERADVISOR_H_
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "src/pileuppoker/card.h"
+#include "src/pileuppoker/packed_layout.h"
+
+namespace puzzmo {
+
+// PileupPokerAdvisor
+//
+// Recommends where to place each card of a Pile-Up Poker deal as it arrives,
+// so as to maximize the expected score of the finished layout. Spots are
+// indexed as for `PileupPokerSolver`, with 16-19 the discards. The cards still
+// to come are assumed to be drawn uniformly from a known deck.
+class PileupPokerAdvisor {
+ public:
+  // PileupPokerAdvisor::Parameters
+  //
+  // Options for trading accuracy against time.
+  struct Parameters {
+    // How long to spend on one recommendation. Once at least one rollout has
+    // been played from each spot, sampling stops when this runs out.
+    absl::Duration time_budget = absl::Milliseconds(80);
+
+    // If placing the card leaves at most this many cards to draw, the expected
+    // score of each spot is computed exactly instead of sampled.
+    int max_exact_draws = 2;
+
+    // The most rollouts to play from each spot, whatever the time budget.
+    int max_rollouts = 1 << 20;
+
+    // Seeds the sampling of future draws, so that advice can be reproduced.
+    uint32_t seed = 0;
+  };
+
+  // PileupPokerAdvisor::Advice
+  //
+  // Where to place a card, and the expected score of the layout if it is
+  // placed there. The expectation is exact if `exact` is true, and otherwise
+  // the mean of `rollouts` sampled games.
+  struct Advice {
+    int spot;
+    double expected_score;
+    bool exact;
+    int rollouts;
+  };
+
+  PileupPokerAdvisor() : PileupPokerAdvisor(Parameters()) {}
+  explicit PileupPokerAdvisor(Parameters params)
+      : params_(params), rng_(params.seed) {}
+
+  // PileupPokerAdvisor::Advise()
+  //
+  // Recommends an empty spot of `layout`, which must have 20 spots, for
+  // `card`. `deck` holds every card that might still be drawn after it, and
+  // must hold enough to fill the other empty spots.
+  //
+  // Each spot is scored by expectimax over the draws still to come: the mean,
+  // over the next card drawn, of the best spot for it, and so on. Once too
+  // many draws remain for that, it is estimated by rollouts instead: the same
+  // sampled draws are played out from every spot, each card placed where it
+  // most improves the layout's outlook, until the time budget runs out.
+  //
+  // Returns an error if the layout does not have 20 spots or has no empty
+  // spot, if `deck` holds too few cards to fill the other empty spots, or if
+  // any card appears twice between `layout`, `card` and `deck`.
+  absl::StatusOr<Advice> Advise(const std::vector<std::optional<Card>> &layout,
+                                const Card &card,
+                                const std::vector<Card> &deck);
+
+ private:
+  // PileupPokerAdvisor::ExpectedScore()
+  //
+  // Returns the exact expected score of `layout`, with the spots in `filled`
+  // placed, once the rest are filled optimally with cards drawn from the
+  // members of `deck_` not in `drawn`.
+  double ExpectedScore(PackedLayout &layout, uint32_t filled,
+                       uint64_t drawn) const;
+
+  // PileupPokerAdvisor::Rollout()
+  //
+  // Places each of `draws` in turn into `layout` by `Outlook()`, and returns
+  // the score of the finished layout.
+  int Rollout(PackedLayout layout, uint32_t filled,
+              const std::vector<PackedCard> &draws) const;
+
+  // PileupPokerAdvisor::Outlook()
+  //
+  // A quick estimate of how much the line through `cells` is worth, used to
+  // choose spots during rollouts. Full lines are worth their score, and others
+  // the best hand they could still become, discounted for each missing card.
+  static double Outlook(const PackedLayout &layout, uint32_t filled,
+                        const std::array<int, 4> &cells);
+
+  const Parameters params_;
+  std::vector<PackedCard> deck_;
+  std::mt19937 rng_;
+};
+
+}  // namespace puzzmo
+
+#endif
@@ -0,0 +1,90 @@
+#include "pile_up_poker_advisor.h"
+
+#include <optional>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/time/time.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "src/pileuppoker/test_cards.h"
+
+namespace puzzmo {
+namespace {
+
+using absl_testing::IsOk;
+using absl_testing::StatusIs;
+
+// `BestTestLayout()`, with spots listed in `empty` left open.
+std::vector<std::optional<Card>> Layout(const std::vector<int> &empty) {
+  const std::vector<Card> cards = BestTestLayout();
+  std::vector<std::optional<Card>> layout(cards.begin(), cards.end());
+  for (int spot : empty) layout[spot].reset();
+  return layout;
+}
+
+TEST(PileupPokerAdvisorTest, AdviseRejectsBadLayouts) {
+  PileupPokerAdvisor advisor;
+  EXPECT_THAT(advisor.Advise(std::vector<std::optional<Card>>(16),
+                             Cards({"2S"})[0], {}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(advisor.Advise(Layout({}), Cards({"2S"})[0], {}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(advisor.Advise(Layout({0, 1}), Cards({"JC"})[0], {}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  // The card to place is already on the layout, or also in the deck.
+  EXPECT_THAT(advisor.Advise(Layout({0}), Cards({"9C"})[0], {}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(
+      advisor.Advise(Layout({0, 1}), Cards({"JC"})[0], Cards({"9C", "JC"})),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+  // The deck repeats a card.
+  EXPECT_THAT(
+      advisor.Advise(Layout({0, 1}), Cards({"JC"})[0], Cards({"2S", "2S"})),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(PileupPokerAdvisorTest, AdviseSearchesLastDrawsExactly) {
+  // The jack and king of clubs complete the corners either way round, but the
+  // jack also completes a straight in the first column.
+  PileupPokerAdvisor advisor;
+  absl::StatusOr<PileupPokerAdvisor::Advice> advice =
+      advisor.Advise(Layout({0, 15}), Cards({"JC"})[0], Cards({"KC"}));
+  ASSERT_THAT(advice, IsOk());
+  EXPECT_EQ(advice->spot, 0);
+  EXPECT_TRUE(advice->exact);
+  EXPECT_DOUBLE_EQ(advice->expected_score, 2665);
+
+  // If the next card might be either of two, the layout only scores 2665 half
+  // the time.
+  advice = advisor.Advise(Layout({0, 15}), Cards({"JC"})[0],
+                          Cards({"KC", "2S"}));
+  ASSERT_THAT(advice, IsOk());
+  EXPECT_TRUE(advice->exact);
+  EXPECT_LT(advice->expected_score, 2665);
+}
+
+TEST(PileupPokerAdvisorTest, AdviseSamplesReproducibly) {
+  const std::vector<Card> deck =
+      Cards({"2S", "3H", "4C", "5D", "7S", "9S", "QH", "AS"});
+  PileupPokerAdvisor::Parameters params = {
+      .time_budget = absl::InfiniteDuration(), .max_rollouts = 50, .seed = 7};
+  PileupPokerAdvisor first(params), second(params);
+  absl::StatusOr<PileupPokerAdvisor::Advice> first_advice =
+      first.Advise(Layout({0, 5, 10, 15, 16}), Cards({"JC"})[0], deck);
+  absl::StatusOr<PileupPokerAdvisor::Advice> second_advice =
+      second.Advise(Layout({0, 5, 10, 15, 16}), Cards({"JC"})[0], deck);
+  ASSERT_THAT(first_advice, IsOk());
+  ASSERT_THAT(second_advice, IsOk());
+  EXPECT_FALSE(first_advice->exact);
+  EXPECT_EQ(first_advice->rollouts, 50);
+  EXPECT_THAT(first_advice->spot, testing::AnyOf(0, 5, 10, 15, 16));
+  EXPECT_EQ(first_advice->spot, second_advice->spot);
+  EXPECT_DOUBLE_EQ(first_advice->expected_score,
+                   second_advice->expected_score);
+}
+
+}  // namespace
+}  // namespace puzzmo
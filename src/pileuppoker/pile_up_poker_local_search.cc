@@ -0,0 +1,149 @@
+#include "pile_up_poker_local_search.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "src/pileuppoker/deal.h"
+
+namespace puzzmo {
+namespace {
+
+constexpr int kNumCards = kDealSize;
+constexpr int kGridSize = 16;
+
+// How many swaps to try between looks at the clock.
+constexpr int kClockInterval = 256;
+
+// The share of the discards' score that `Objective()` credits when every
+// other line scores but one.
+constexpr double kPartialDiscardCredit = 0.5;
+
+}  // namespace
+
+/** * * * * * * * * * * *
+ * Public class methods *
+ ** * * * * * * * * * * */
+
+absl::StatusOr<std::vector<Card>> PileupPokerLocalSearch::Solve() {
+  if (absl::Status s = ValidateDeal(cards_); !s.ok()) return s;
+
+  layout_ = PackLayout(cards_);
+  line_scores_ = ScoreLines(layout_);
+  best_layout_ = layout_;
+  best_score_ = Score();
+
+  const absl::Time start = absl::Now();
+  std::uniform_int_distribution<int> pick_spot(0, kNumCards - 1);
+  std::uniform_real_distribution<double> pick_chance(0, 1);
+  double objective = Objective();
+  double temperature = params_.initial_temperature;
+  for (iterations_ = 0; iterations_ < params_.max_iterations; ++iterations_) {
+    if (iterations_ % kClockInterval == 0) {
+      const double progress = std::max(
+          static_cast<double>(iterations_) / params_.max_iterations,
+          absl::FDivDuration(absl::Now() - start, params_.time_budget));
+      if (progress >= 1) break;
+      const double round_progress =
+          progress * params_.num_rounds -
+          std::floor(progress * params_.num_rounds);
+      temperature =
+          params_.initial_temperature *
+          std::pow(params_.final_temperature / params_.initial_temperature,
+                   round_progress);
+    }
+
+    // Swapping two discards changes nothing, so at least one spot is in the
+    // grid.
+    const int a = pick_spot(rng_), b = pick_spot(rng_);
+    if (a == b || (a >= kGridSize && b >= kGridSize)) continue;
+    Swap(a, b);
+    const double new_objective = Objective();
+    if (new_objective < objective &&
+        pick_chance(rng_) >=
+            std::exp((new_objective - objective) / temperature)) {
+      Swap(a, b);
+      continue;
+    }
+    objective = new_objective;
+    if (const int score = Score(); score > best_score_) {
+      best_score_ = score;
+      best_layout_ = layout_;
+    }
+  }
+  Polish();
+
+  std::vector<Card> layout;
+  for (PackedCard card : best_layout_) layout.push_back(UnpackCard(card));
+  return layout;
+}
+
+/** * * * * * * * * *
+ * Private helpers *
+ ** * * * * * * * * */
+
+void PileupPokerLocalSearch::Polish() {
+  layout_ = best_layout_;
+  line_scores_ = ScoreLines(layout_);
+  while (true) {
+    int best_a = -1, best_b = -1;
+    for (int a = 0; a < kGridSize; ++a) {
+      for (int b = a + 1; b < kNumCards; ++b) {
+        Swap(a, b);
+        if (const int score = Score(); score > best_score_) {
+          best_score_ = score;
+          best_a = a;
+          best_b = b;
+        }
+        Swap(a, b);
+      }
+    }
+    if (best_a < 0) break;
+    Swap(best_a, best_b);
+  }
+  best_layout_ = layout_;
+}
+
+void PileupPokerLocalSearch::Swap(int a, int b) {
+  std::swap(layout_[a], layout_[b]);
+  for (int spot : {a, b}) {
+    for (int line : kSpotLines[spot]) {
+      if (line < 0) break;
+      const std::array<int, 4> &cells = kLayoutLines[line];
+      line_scores_[line] =
+          ScorePackedHand(layout_[cells[0]], layout_[cells[1]],
+                          layout_[cells[2]], layout_[cells[3]]);
+    }
+  }
+}
+
+int PileupPokerLocalSearch::Score() const {
+  int score = 0;
+  bool count_discard = true;
+  for (int line = 0; line < kDiscardLine; ++line) {
+    score += kLineMultipliers[line] * line_scores_[line];
+    count_discard &= line_scores_[line] != 0;
+  }
+  if (count_discard)
+    score += kLineMultipliers[kDiscardLine] * line_scores_[kDiscardLine];
+  return score;
+}
+
+double PileupPokerLocalSearch::Objective() const {
+  int score = 0, scoring_lines = 0;
+  for (int line = 0; line < kDiscardLine; ++line) {
+    score += kLineMultipliers[line] * line_scores_[line];
+    scoring_lines += line_scores_[line] != 0;
+  }
+  const double discard_credit =
+      scoring_lines == kDiscardLine
+          ? 1
+          : kPartialDiscardCredit * scoring_lines / (kDiscardLine - 1);
+  return score + discard_credit * kLineMultipliers[kDiscardLine] *
+                     line_scores_[kDiscardLine];
+}
+
+}  // namespace puzzmo
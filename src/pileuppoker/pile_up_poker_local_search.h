@@ -0,0 +1,119 @@
+// -----------------------------------------------------------------------------
+// File: pile_up_poker_local_search.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines an anytime local search for Pile-Up Poker, which
+// finds a good layout of a deal in a few milliseconds, with no promise that it
+// is the best one.
+
+#ifndef PUZZMO_PILEUPPOKER_PILEUPPOKERLOCALSEARCH_H_
+#define PUZZMO_PILEUPPOKER_PILEUPPOKERLOCALSEARCH_H_
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "src/pileuppoker/card.h"
+#include "src/pileuppoker/packed_layout.h"
+
+namespace puzzmo {
+
+// PileupPokerLocalSearch
+//
+// Improves a layout of a Pile-Up Poker deal by simulated annealing over swaps
+// of two spots, either both in the grid or one in the grid and one among the
+// discards. Layouts are indexed as for `PileupPokerSolver`, which should be
+// used instead whenever there is time to prove an optimum.
+class PileupPokerLocalSearch {
+ public:
+  // PileupPokerLocalSearch::Parameters
+  //
+  // Options for tuning the search.
+  struct Parameters {
+    // How long to search for. The search stops at whichever of this and
+    // `max_iterations` comes first.
+    absl::Duration time_budget = absl::Milliseconds(10);
+
+    // The most swaps to try.
+    int max_iterations = 1 << 30;
+
+    // Seeds the choice of swaps, so that a search bounded by `max_iterations`
+    // can be reproduced.
+    uint32_t seed = 0;
+
+    // The temperature cools geometrically from the first to the second over
+    // each round of the search, and is raised again at the start of the next.
+    // A swap that loses `x` points is accepted with probability
+    // exp(-x / temperature).
+    double initial_temperature = 100;
+    double final_temperature = 1;
+    int num_rounds = 4;
+  };
+
+  explicit PileupPokerLocalSearch(std::vector<Card> cards)
+      : PileupPokerLocalSearch(std::move(cards), Parameters()) {}
+  PileupPokerLocalSearch(std::vector<Card> cards, Parameters params)
+      : cards_(std::move(cards)), params_(params), rng_(params.seed) {}
+
+  // PileupPokerLocalSearch::Solve()
+  //
+  // Returns the highest-scoring layout of the cards that the search came
+  // across, starting from the cards in the order given, after improving it by
+  // swaps until no single swap helps. Returns an error unless there are
+  // exactly 20 distinct cards.
+  absl::StatusOr<std::vector<Card>> Solve();
+
+  // PileupPokerLocalSearch::best_score()
+  //
+  // The score of the layout returned by the last call to `Solve()`.
+  int best_score() const { return best_score_; }
+
+  // PileupPokerLocalSearch::iterations()
+  //
+  // The number of swaps tried by the last call to `Solve()`.
+  int iterations() const { return iterations_; }
+
+ private:
+  // PileupPokerLocalSearch::Swap()
+  //
+  // Swaps the cards in spots `a` and `b`, and rescores only the lines through
+  // them.
+  void Swap(int a, int b);
+
+  // PileupPokerLocalSearch::Score()
+  //
+  // Totals `line_scores_`.
+  int Score() const;
+
+  // PileupPokerLocalSearch::Objective()
+  //
+  // What the annealing maximizes: the score, except that the discards are
+  // credited in part when some other line does not score, in proportion to
+  // how many do. Otherwise the discards would only be noticed once every line
+  // happened to score at the same time.
+  double Objective() const;
+
+  // PileupPokerLocalSearch::Polish()
+  //
+  // Makes the best swap of the best layout found until none improves it.
+  void Polish();
+
+  std::vector<Card> cards_;
+  const Parameters params_;
+  std::mt19937 rng_;
+
+  PackedLayout layout_;
+  std::array<int, kNumLines> line_scores_;
+
+  PackedLayout best_layout_;
+  int best_score_ = -1;
+  int iterations_ = 0;
+};
+
+}  // namespace puzzmo
+
+#endif
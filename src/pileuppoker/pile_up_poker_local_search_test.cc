@@ -0,0 +1,55 @@
+#include "pile_up_poker_local_search.h"
+
+#include <utility>
+#include <vector>
+
+#include "absl/status/status_matchers.h"
+#include "absl/time/time.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "src/pileuppoker/pile_up_poker_solver.h"
+#include "src/pileuppoker/test_cards.h"
+
+namespace puzzmo {
+namespace {
+
+using absl_testing::IsOk;
+
+TEST(PileupPokerLocalSearchTest, SolveFindsLocalOptimum) {
+  PileupPokerLocalSearch search(
+      TestDeal(),
+      {.time_budget = absl::InfiniteDuration(), .max_iterations = 100000});
+  absl::StatusOr<std::vector<Card>> layout = search.Solve();
+  ASSERT_THAT(layout, IsOk());
+  EXPECT_EQ(search.iterations(), 100000);
+  EXPECT_THAT(*layout, testing::UnorderedElementsAreArray(TestDeal()));
+  EXPECT_EQ(PileupPokerSolver::Score(*layout), search.best_score());
+  EXPECT_LE(search.best_score(), 2665);
+  EXPECT_GE(search.best_score(), 2000);
+
+  // No single swap improves the layout.
+  for (int a = 0; a < 20; ++a) {
+    for (int b = a + 1; b < 20; ++b) {
+      std::vector<Card> swapped = *layout;
+      std::swap(swapped[a], swapped[b]);
+      EXPECT_LE(PileupPokerSolver::Score(swapped), search.best_score());
+    }
+  }
+}
+
+TEST(PileupPokerLocalSearchTest, SolveIsReproducible) {
+  const PileupPokerLocalSearch::Parameters params = {
+      .time_budget = absl::InfiniteDuration(),
+      .max_iterations = 20000,
+      .seed = 3};
+  PileupPokerLocalSearch first(TestDeal(), params), second(TestDeal(),
+                                                             params);
+  absl::StatusOr<std::vector<Card>> first_layout = first.Solve();
+  absl::StatusOr<std::vector<Card>> second_layout = second.Solve();
+  ASSERT_THAT(first_layout, IsOk());
+  ASSERT_THAT(second_layout, IsOk());
+  EXPECT_EQ(*first_layout, *second_layout);
+}
+
+}  // namespace
+}  // namespace puzzmo
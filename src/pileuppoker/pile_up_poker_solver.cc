@@ -1,112 +1,465 @@
 #include "pile_up_poker_solver.h"
 
-#include <string>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <memory>
 
-#include "absl/log/log.h"
-#include "absl/strings/str_cat.h"
-#include "absl/strings/str_join.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "src/pileuppoker/deal.h"
+#include "src/pileuppoker/hand_table.h"
+#include "src/pileuppoker/packed_layout.h"
+#include "src/shared/parallel.h"
 
 namespace puzzmo {
 namespace {
 
-int ScoreHand(const Card &c1, const Card &c2, const Card &c3, const Card &c4,
-              bool &count_discard) {
-  std::vector<Card> hand = {c1, c2, c3, c4};
-  std::sort(hand.begin(), hand.end());
-
-  bool flush = (c1.suit == c2.suit && c2.suit == c3.suit && c3.suit == c4.suit);
-  bool straight =
-      (hand[1].rank - hand[0].rank == 1 && hand[2].rank - hand[1].rank == 1 &&
-       hand[3].rank - hand[2].rank == 1);
-  if (straight && flush) return 450;             // Straight Flush
-  if (straight) return 180;                      // Straight
-  if (flush) return 80;                          // Flush
-  if (hand[0].rank == hand[3].rank) return 325;  // 4 of a Kind
-  if (hand[0].rank == hand[2].rank || hand[1].rank == hand[3].rank)
-    return 125;  // 3 of a Kind
-  if (hand[0].rank == hand[1].rank && hand[2].rank == hand[3].rank)
-    return 60;  // 2 Pair
-  if (hand[0].rank == hand[1].rank || hand[1].rank == hand[2].rank ||
-      hand[2].rank == hand[3].rank)
-    return 5;  // Pair
-
-  count_discard = false;
-  return 0;  // Non-scoring
+constexpr int kNumCards = kDealSize;
+constexpr int kGridSize = 16;
+
+// The order in which `SearchGrid()` fills the grid: corners first, as they
+// count towards three hands, then the rest of the border, then the middle.
+constexpr std::array<int, kGridSize> kCellOrder = {0, 3,  12, 15, 1, 2, 4, 8,
+                                                   7, 11, 13, 14, 5, 6, 9, 10};
+
+constexpr bool IsCorner(int cell) {
+  return cell == 0 || cell == 3 || cell == 12 || cell == 15;
+}
+
+constexpr int kDiscardMultiplier = kLineMultipliers[kDiscardLine];
+
+// Raises `a` to `value` if it is lower.
+void RaiseTo(std::atomic<int> &a, int value) {
+  int old = a;
+  while (value > old && !a.compare_exchange_weak(old, value)) {
+  }
 }
 
 }  // namespace
 
-//
+/** * * * * * * * * * * *
+ * Public class methods *
+ ** * * * * * * * * * * */
+
+absl::StatusOr<std::vector<Card>> PileupPokerSolver::Solve() {
+  if (absl::Status s = ValidateDeal(cards_); !s.ok()) return s;
+
+  BuildTables();
+  FindSymmetries();
+  best_score_ = -1;
+
+  // Bound every choice of discards before searching any of them, so that the
+  // most promising are searched first and the rest can be skipped outright.
+  std::vector<std::pair<int, uint32_t>> discards;
+  for (int a = 0; a < kNumCards; ++a) {
+    for (int b = a + 1; b < kNumCards; ++b) {
+      for (int c = b + 1; c < kNumCards; ++c) {
+        for (int d = c + 1; d < kNumCards; ++d) {
+          const uint32_t cards = (1 << a) | (1 << b) | (1 << c) | (1 << d);
+          if (Deal(cards)) discards.push_back({-UpperBound(), cards});
+        }
+      }
+    }
+  }
+  std::sort(discards.begin(), discards.end());
+  if (params_.num_threads > 1) {
+    std::vector<uint32_t> sets;
+    for (const auto &[negative_bound, cards] : discards) sets.push_back(cards);
+    SearchInParallel(sets);
+  } else {
+    for (const auto &[negative_bound, cards] : discards) {
+      if (-negative_bound <= best_score_) break;
+      Deal(cards);
+      SearchGrid(0);
+    }
+  }
+
+  std::vector<Card> layout;
+  for (int card : best_layout_) layout.push_back(cards_[card]);
+  return layout;
+}
+
+int PileupPokerSolver::Score(const std::vector<Card> &layout) {
+  return ScoreLayout(PackLayout(layout));
+}
+
+/** * * * * * * * * *
+ * Solving helpers *
+ ** * * * * * * * * */
+
+void PileupPokerSolver::BuildTables() {
+  const HandTable &table = HandTable::Get();
+  auto tables = std::make_shared<Tables>();
+  std::vector<int> &hand_scores = tables->hand_scores;
+  std::vector<int> &best_hands = tables->best_hands;
+  std::vector<int> &partition_scores = tables->partition_scores;
+  hand_scores.assign(1 << kNumCards, 0);
+  for (int a = 0; a < kNumCards; ++a) {
+    for (int b = a + 1; b < kNumCards; ++b) {
+      for (int c = b + 1; c < kNumCards; ++c) {
+        for (int d = c + 1; d < kNumCards; ++d) {
+          hand_scores[(1 << a) | (1 << b) | (1 << c) | (1 << d)] =
+              table.Score(cards_[a], cards_[b], cards_[c], cards_[d]);
+        }
+      }
+    }
+  }
 
-std::vector<Card> PileupPokerSolver::Solve() const {
-  int score = 0;
-  int best_score = -1;
-  std::vector<Card> best_layout;
-  std::vector<Card> cards = cards_;
+  best_hands.assign(1 << kNumCards, 0);
+  for (uint32_t cards = 1; cards < best_hands.size(); ++cards) {
+    int best = std::popcount(cards) == 4 ? hand_scores[cards] : 0;
+    for (uint32_t left = cards; left != 0; left &= left - 1)
+      best = std::max(best, best_hands[cards & ~(left & -left)]);
+    best_hands[cards] = best;
+  }
+
+  // Every split of a set into hands puts its lowest card in some hand, so only
+  // the hands containing that card need to be tried.
+  partition_scores.assign(1 << kNumCards, 0);
+  for (uint32_t cards = 1; cards < partition_scores.size(); ++cards) {
+    if (std::popcount(cards) % 4 != 0) continue;
+    const uint32_t lowest = cards & -cards;
+    int best = 0;
+    for (uint32_t x = cards & ~lowest; x != 0; x &= x - 1) {
+      for (uint32_t y = x & (x - 1); y != 0; y &= y - 1) {
+        for (uint32_t z = y & (y - 1); z != 0; z &= z - 1) {
+          const uint32_t hand = lowest | (x & -x) | (y & -y) | (z & -z);
+          best = std::max(
+              best, hand_scores[hand] + partition_scores[cards & ~hand]);
+        }
+      }
+    }
+    partition_scores[cards] = best;
+  }
+  tables_ = std::move(tables);
+}
+
+bool PileupPokerSolver::Deal(uint32_t discards) {
+  // Sorted sets of cards compare as the lowest card in just one of them does.
+  ties_[0].clear();
+  for (int i = 0; i < symmetries_.size(); ++i) {
+    uint32_t image = 0;
+    for (uint32_t left = discards; left != 0; left &= left - 1)
+      image |= 1 << symmetries_[i].cards[std::countr_zero(left)];
+    const uint32_t lowest_difference = (image ^ discards) & -(image ^ discards);
+    if (lowest_difference & image) return false;
+    if (lowest_difference == 0) ties_[0].push_back({i, 0});
+  }
+
+  layout_.fill(-1);
+  lines_.fill(0);
+  pool_ = 0;
+  pool_ranks_.fill(0);
+  pool_suits_.fill(0);
+  int next_discard = kGridSize;
+  for (int i = 0; i < kNumCards; ++i) {
+    if (discards & (1 << i)) {
+      layout_[next_discard++] = i;
+      continue;
+    }
+    pool_ |= 1 << i;
+    ++pool_ranks_[cards_[i].rank];
+    pool_suits_[cards_[i].suit] |= 1 << cards_[i].rank;
+  }
+  discard_score_ = tables_->hand_scores[discards];
+  return true;
+}
+
+void PileupPokerSolver::SearchGrid(int depth) {
+  if (depth == kGridSize) {
+    if (const int score = UpperBound(); score > best_score_) {
+      best_score_ = score;
+      best_layout_ = layout_;
+      if (shared_best_score_ != nullptr) RaiseTo(*shared_best_score_, score);
+    }
+    return;
+  }
+
+  // Bound each placement up front, then try them best first. Ties go to the
+  // lower card index, so the search is deterministic.
+  const int cell = kCellOrder[depth];
+  std::array<std::pair<int, int>, kGridSize> placements;
+  int num_placements = 0;
+  for (uint32_t left = pool_; left != 0; left &= left - 1) {
+    const int card = std::countr_zero(left);
+    Place(cell, card);
+    if (IsCanonical(depth)) {
+      if (const int bound = UpperBound(); CanBeat(bound))
+        placements[num_placements++] = {-bound, card};
+    }
+    Unplace(cell, card);
+  }
+  std::sort(placements.begin(), placements.begin() + num_placements);
+  for (int i = 0; i < num_placements; ++i) {
+    const auto [negative_bound, card] = placements[i];
+    if (!CanBeat(-negative_bound)) break;
+    Place(cell, card);
+    IsCanonical(depth);
+    SearchGrid(depth + 1);
+    Unplace(cell, card);
+  }
+}
+
+bool PileupPokerSolver::CanBeat(int bound) const {
+  if (bound <= best_score_) return false;
+  return shared_best_score_ == nullptr || bound >= *shared_best_score_;
+}
+
+void PileupPokerSolver::Place(int cell, int card) {
+  const uint32_t bit = 1 << card;
+  layout_[cell] = card;
+  lines_[cell / 4] |= bit;
+  lines_[4 + cell % 4] |= bit;
+  if (IsCorner(cell)) lines_[8] |= bit;
+  pool_ &= ~bit;
+  --pool_ranks_[cards_[card].rank];
+  pool_suits_[cards_[card].suit] &= ~(1 << cards_[card].rank);
+}
 
-  std::sort(cards.begin(), cards.end());
+void PileupPokerSolver::Unplace(int cell, int card) {
+  const uint32_t bit = 1 << card;
+  layout_[cell] = -1;
+  lines_[cell / 4] &= ~bit;
+  lines_[4 + cell % 4] &= ~bit;
+  if (IsCorner(cell)) lines_[8] &= ~bit;
+  pool_ |= bit;
+  ++pool_ranks_[cards_[card].rank];
+  pool_suits_[cards_[card].suit] |= 1 << cards_[card].rank;
+}
+
+/** * * * * * * * * *
+ * Parallel search *
+ ** * * * * * * * * */
+
+void PileupPokerSolver::CollectTasks(int depth, uint32_t discards,
+                                     std::vector<int> &prefix,
+                                     std::vector<Task> &tasks) {
+  if (depth == params_.parallel_depth || depth == kGridSize) {
+    tasks.push_back({.discards = discards, .cards = prefix,
+                     .bound = UpperBound()});
+    return;
+  }
+
+  // Order the placements as `SearchGrid()` does, but keep them all, as nothing
+  // has been found yet to prune them against.
+  const int cell = kCellOrder[depth];
+  std::vector<std::pair<int, int>> placements;
+  for (uint32_t left = pool_; left != 0; left &= left - 1) {
+    const int card = std::countr_zero(left);
+    Place(cell, card);
+    if (IsCanonical(depth)) placements.push_back({-UpperBound(), card});
+    Unplace(cell, card);
+  }
+  std::sort(placements.begin(), placements.end());
+  for (const auto &[negative_bound, card] : placements) {
+    Place(cell, card);
+    IsCanonical(depth);
+    prefix.push_back(card);
+    CollectTasks(depth + 1, discards, prefix, tasks);
+    prefix.pop_back();
+    Unplace(cell, card);
+  }
+}
+
+void PileupPokerSolver::SearchInParallel(
+    const std::vector<uint32_t> &discards) {
+  std::vector<Task> tasks;
+  std::vector<int> prefix;
+  for (uint32_t cards : discards) {
+    Deal(cards);
+    CollectTasks(0, cards, prefix, tasks);
+  }
+
+  // Each worker gets its own copy of the solver, and so of the search state.
+  std::atomic<int> shared_best_score = best_score_;
+  std::vector<PileupPokerSolver> workers(
+      std::min<int>(params_.num_threads, tasks.size()), *this);
+  for (PileupPokerSolver &worker : workers)
+    worker.shared_best_score_ = &shared_best_score;
+
+  // A task only needs searching if it might tie the best score so far, since
+  // a tie in an earlier task is what a serial search would have kept.
+  std::vector<int> scores(tasks.size(), -1);
+  std::vector<std::array<int, kNumCards>> layouts(tasks.size());
+  ParallelFor(tasks.size(), workers.size(), [&](int w, int task) {
+    if (tasks[task].bound < shared_best_score) return;
+    PileupPokerSolver &worker = workers[w];
+    worker.Deal(tasks[task].discards);
+    for (int depth = 0; depth < tasks[task].cards.size(); ++depth) {
+      worker.Place(kCellOrder[depth], tasks[task].cards[depth]);
+      worker.IsCanonical(depth);
+    }
+    worker.best_score_ = -1;
+    worker.SearchGrid(tasks[task].cards.size());
+    scores[task] = worker.best_score_;
+    layouts[task] = worker.best_layout_;
+  });
+
+  // Merge in task order, which is the order a serial search would use.
+  for (int task = 0; task < tasks.size(); ++task) {
+    if (scores[task] > best_score_) {
+      best_score_ = scores[task];
+      best_layout_ = layouts[task];
+    }
+  }
+}
+
+/** * * * * * * * * * *
+ * Symmetry breaking *
+ ** * * * * * * * * * */
+
+void PileupPokerSolver::FindSymmetries() {
+  symmetries_.clear();
+  if (!params_.break_symmetries) return;
+
+  // Relabelings of suits that map the deal onto itself, as maps of cards. The
+  // first permutation tried is the identity.
+  std::vector<std::array<int, kNumCards>> relabelings;
+  std::array<int, 4> suits = {kSpades, kHearts, kClubs, kDiamonds};
   do {
-    LOG(ERROR) << score
-               << absl::StrJoin(cards, ", ",
-                                [](std::string *out, const Card &card) {
-                                  absl::StrAppend(out, card.toString());
-                                });  // temp
-    score = Score(cards_);
-    if (score > best_score) {
-      best_layout = cards;
-      best_score = score;
-
-      LOG(ERROR) << " ";
-      LOG(ERROR) << "New best score: " << score;
-      for (int i = 0; i < 4; ++i) {
-        LOG(ERROR) << absl::StrCat(
-            "[", cards[4 * i].toString(), " ", cards[4 * i + 1].toString(), " ",
-            cards[4 * i + 2].toString(), " ", cards[4 * i + 3].toString(), "]");
+    std::array<int, kNumCards> relabeling;
+    bool maps_onto_deal = true;
+    for (int i = 0; i < kNumCards && maps_onto_deal; ++i) {
+      const Card image = {.rank = cards_[i].rank,
+                          .suit = static_cast<Suit>(suits[cards_[i].suit])};
+      const auto it = std::find(cards_.begin(), cards_.end(), image);
+      maps_onto_deal = it != cards_.end();
+      if (maps_onto_deal) relabeling[i] = it - cards_.begin();
+    }
+    if (maps_onto_deal) relabelings.push_back(relabeling);
+  } while (std::next_permutation(suits.begin(), suits.end()));
+
+  // The grid's symmetries fix the set of corners, so rows can only be swapped
+  // in pairs that are both or neither outer ones, and likewise columns. The
+  // first of each is the identity, and the identity overall is skipped.
+  constexpr std::array<std::array<int, 4>, 4> kSwaps = {
+      {{0, 1, 2, 3}, {3, 1, 2, 0}, {0, 2, 1, 3}, {3, 2, 1, 0}}};
+  for (int r = 0; r < kSwaps.size(); ++r) {
+    for (int c = 0; c < kSwaps.size(); ++c) {
+      for (int transpose : {0, 1}) {
+        Symmetry symmetry;
+        for (int cell = 0; cell < kGridSize; ++cell) {
+          const int row = kSwaps[r][cell / 4], col = kSwaps[c][cell % 4];
+          symmetry.sources[transpose ? 4 * col + row : 4 * row + col] = cell;
+        }
+        for (int s = 0; s < relabelings.size(); ++s) {
+          if (r == 0 && c == 0 && transpose == 0 && s == 0) continue;
+          symmetry.cards = relabelings[s];
+          symmetries_.push_back(symmetry);
+        }
+      }
+    }
+  }
+}
+
+bool PileupPokerSolver::IsCanonical(int depth) {
+  std::vector<std::pair<int, int>> &ties = ties_[depth + 1];
+  ties.clear();
+  for (auto [i, position] : ties_[depth]) {
+    // Compare the layout with its image one position at a time, for as long as
+    // both are known.
+    const Symmetry &symmetry = symmetries_[i];
+    int order = 0;
+    for (; position <= depth && order == 0; ++position) {
+      const int cell = kCellOrder[position];
+      const int source = layout_[symmetry.sources[cell]];
+      if (source < 0) break;
+      order = layout_[cell] - symmetry.cards[source];
+    }
+    if (order > 0) return false;
+    if (order == 0) ties.push_back({i, position});
+  }
+  return true;
+}
+
+/** * * * * * * * *
+ * Scoring bounds *
+ ** * * * * * * * */
+
+int PileupPokerSolver::LineBound(uint32_t line) const {
+  const int placed = std::popcount(line);
+  if (placed == 4) return tables_->hand_scores[line];
+  if (placed == 0) return tables_->best_hands[pool_];
+  const int needed = 4 - placed;
+
+  std::array<int, 14> ranks = {};
+  uint16_t rank_bits = 0;
+  int suit_bits = 0;
+  bool paired = false;
+  for (uint32_t left = line; left != 0; left &= left - 1) {
+    const Card &card = cards_[std::countr_zero(left)];
+    paired |= ranks[card.rank]++ > 0;
+    rank_bits |= 1 << card.rank;
+    suit_bits |= 1 << card.suit;
+  }
+  const bool suited = std::has_single_bit(static_cast<unsigned>(suit_bits));
+  const int suit = std::countr_zero(static_cast<unsigned>(suit_bits));
+
+  // Whether the ranks in `available` complete a straight.
+  auto straight_from = [&](uint16_t available) {
+    if (paired) return false;
+    for (int low = kTwo; low + 3 <= kAce; ++low) {
+      const uint16_t window = 0xF << low;
+      if ((rank_bits & ~window) != 0) continue;
+      const uint16_t missing = window & ~rank_bits;
+      if ((available & missing) == missing) return true;
+    }
+    return false;
+  };
+
+  if (suited && straight_from(pool_suits_[suit])) return kStraightFlush;
+  if (std::has_single_bit(rank_bits) &&
+      pool_ranks_[std::countr_zero(rank_bits)] >= needed)
+    return kFourOfAKind;
+  if (straight_from(pool_suits_[0] | pool_suits_[1] | pool_suits_[2] |
+                    pool_suits_[3]))
+    return kStraight;
+  for (int r = kTwo; r <= kAce; ++r) {
+    if (placed - ranks[r] <= 1 && 3 - ranks[r] <= needed &&
+        ranks[r] + pool_ranks_[r] >= 3)
+      return kThreeOfAKind;
+  }
+  if (suited && std::popcount(pool_suits_[suit]) >= needed) return kFlush;
+  for (int r1 = kTwo; r1 <= kAce; ++r1) {
+    if (ranks[r1] > 2 || ranks[r1] + pool_ranks_[r1] < 2) continue;
+    for (int r2 = r1 + 1; r2 <= kAce; ++r2) {
+      if (ranks[r1] + ranks[r2] == placed && ranks[r2] <= 2 &&
+          ranks[r2] + pool_ranks_[r2] >= 2)
+        return kTwoPair;
+    }
+  }
+  for (int r = kTwo; r <= kAce; ++r) {
+    if (placed - ranks[r] <= 2 && 2 - ranks[r] <= needed &&
+        ranks[r] + pool_ranks_[r] >= 2)
+      return kPair;
+  }
+  return 0;
+}
+
+int PileupPokerSolver::UpperBound() const {
+  int bound = 0;
+  bool all_score = true;
+  for (int first : {0, 4}) {
+    int open_bound = 0;
+    uint32_t open_cards = pool_;
+    for (int i = first; i < first + 4; ++i) {
+      const int line_bound = LineBound(lines_[i]);
+      all_score &= line_bound > 0;
+      if (std::popcount(lines_[i]) == 4) {
+        bound += line_bound;
+      } else {
+        open_bound += line_bound;
+        open_cards |= lines_[i];
       }
     }
-  } while (std::next_permutation(cards.begin(), cards.end()));
-
-  return best_layout;
-}
-
-int PileupPokerSolver::Score(std::vector<Card> cards) const {
-  // Indices in the vector correspond to board spots as follows:
-  //
-  // 16      0  1  2  3
-  // 17      4  5  6  7
-  // 18      8  9 10 11
-  // 19     12 13 14 15
-  //
-  // Therefore, these are the hands to be scored, and multipliers
-  // - 0, 1, 2, 3
-  // - 4, 5, 6, 7
-  // - 8, 9, 10, 11
-  // - 12, 13, 14, 15
-  // - 0, 4, 8, 12
-  // - 1, 5, 9, 13
-  // - 2, 6, 10, 14
-  // - 3, 7, 11, 15
-  // - 0, 3, 12, 15     x2
-  // - 16, 17, 18, 19   x3 (only if all others score!)
-  int score = 0;
-  bool count_discard = true;
-  score += ScoreHand(cards[0], cards[1], cards[2], cards[3], count_discard);
-  score += ScoreHand(cards[4], cards[5], cards[6], cards[7], count_discard);
-  score += ScoreHand(cards[8], cards[9], cards[10], cards[11], count_discard);
-  score += ScoreHand(cards[12], cards[13], cards[14], cards[15], count_discard);
-  score += ScoreHand(cards[0], cards[4], cards[8], cards[12], count_discard);
-  score += ScoreHand(cards[1], cards[5], cards[9], cards[13], count_discard);
-  score += ScoreHand(cards[2], cards[6], cards[10], cards[14], count_discard);
-  score += ScoreHand(cards[3], cards[7], cards[11], cards[15], count_discard);
-  score +=
-      2 * ScoreHand(cards[0], cards[3], cards[12], cards[15], count_discard);
-
-  if (count_discard) {
-    score += 3 * ScoreHand(cards[16], cards[17], cards[18], cards[19],
-                           count_discard);
-  }
-
-  return score;
-}
-
-}  // namespace puzzmo
\ No newline at end of file
+    bound += std::min(open_bound, tables_->partition_scores[open_cards]);
+  }
+  const int corners = LineBound(lines_[8]);
+  all_score &= corners > 0;
+  bound += 2 * corners;
+  if (all_score) bound += kDiscardMultiplier * discard_score_;
+  return bound;
+}
+
+}  // namespace puzzmo
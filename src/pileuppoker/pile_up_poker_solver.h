@@ -1,22 +1,249 @@
+// -----------------------------------------------------------------------------
+// File: pile_up_poker_solver.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines the solver class for Pile-Up Poker, which lays out
+// twenty cards as a 4x4 grid plus four discards so as to maximize the score of
+// the poker hands they form.
+
 #ifndef PUZZMO_PILEUPPOKER_PILEUPPOKERSOLVER_H_
 #define PUZZMO_PILEUPPOKER_PILEUPPOKERSOLVER_H_
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
 #include <vector>
 
+#include "absl/status/statusor.h"
 #include "src/pileuppoker/card.h"
 
 namespace puzzmo {
 
+// PileupPokerSolver
+//
+// Finds the highest-scoring layout of a Pile-Up Poker deal. Indices in a layout
+// correspond to board spots as follows:
+//
+//    0  1  2  3      16
+//    4  5  6  7      17
+//    8  9 10 11      18
+//   12 13 14 15      19
+//
+// Each row, each column and the four corners (x2) are scored as poker hands.
+// The discards (16-19) are scored too, x3, but only if every other hand scores.
 class PileupPokerSolver {
  public:
-  explicit PileupPokerSolver(std::vector<Card> cards) : cards_(cards) {};
-  std::vector<Card> Solve() const;
+  // PileupPokerSolver::Parameters
+  //
+  // Options for tuning the search.
+  struct Parameters {
+    // Whether to search only one layout out of each set that the board's
+    // symmetries make equivalent. The board scores the same after swapping
+    // the middle two rows, swapping the outer two, doing either to the
+    // columns, or transposing it, and so does any layout whose suits are
+    // relabeled if the deal is unchanged by that relabeling. Of each set of
+    // equivalent layouts only the lexicographically least, in search order, is
+    // searched.
+    bool break_symmetries = true;
+
+    // The number of threads to search with. If greater than 1, the branches at
+    // the first `parallel_depth` cells of the grid, under every choice of
+    // discards, are enumerated up front and shared out between threads. The
+    // result is the same as that of a serial search.
+    int num_threads = 1;
+
+    // How many cells of the grid to fill before handing the branches out to
+    // threads. Each choice of discards is a task at 0, but the best few of
+    // them hold most of the work, so 1 balances better.
+    int parallel_depth = 1;
+  };
+
+  explicit PileupPokerSolver(std::vector<Card> cards)
+      : PileupPokerSolver(std::move(cards), Parameters()) {}
+  PileupPokerSolver(std::vector<Card> cards, Parameters params)
+      : cards_(std::move(cards)), params_(params) {}
+
+  // PileupPokerSolver::Solve()
+  //
+  // Returns the highest-scoring layout of the cards. The search places the
+  // discards first and then the grid cell by cell, pruning any branch whose
+  // upper bound cannot beat the best layout found so far, so the result is a
+  // proven optimum. Returns an error unless there are exactly 20 distinct
+  // cards.
+  //
+  // If `Parameters::num_threads` is greater than 1, the search is split
+  // between that many threads, and returns the same layout.
+  absl::StatusOr<std::vector<Card>> Solve();
+
+  // PileupPokerSolver::best_score()
+  //
+  // The score of the layout returned by the last call to `Solve()`.
+  int best_score() const { return best_score_; }
+
+  // PileupPokerSolver::Score()
+  //
+  // Scores a full `layout` of 20 cards, indexed as above.
+  static int Score(const std::vector<Card> &layout);
 
  private:
-  const std::vector<Card> cards_;
-  int Score(std::vector<Card> cards) const;
+  /** * * * * * * * * *
+   * Solving helpers *
+   ** * * * * * * * * */
+
+  // PileupPokerSolver::BuildTables()
+  //
+  // Fills `tables_`.
+  void BuildTables();
+
+  // PileupPokerSolver::Deal()
+  //
+  // Resets the search state to an empty grid, with the cards in `discards`
+  // discarded and the rest in `pool_`. Returns false without dealing if a
+  // symmetry maps `discards` to a lesser set, as then the equivalent layouts
+  // are searched under that set instead.
+  bool Deal(uint32_t discards);
+
+  // PileupPokerSolver::SearchGrid()
+  //
+  // Tries every card left in `pool_` in the `depth`th cell of `kCellOrder`,
+  // recursing into the most promising placements first.
+  void SearchGrid(int depth);
+
+  // PileupPokerSolver::CanBeat()
+  //
+  // Returns whether a branch with this upper bound could hold a layout better
+  // than this search's best. When searching in parallel, it must also be able
+  // to tie the best score of every worker, or a serial search would not have
+  // kept it either.
+  bool CanBeat(int bound) const;
+
+  // PileupPokerSolver::Place()
+  //
+  // Moves `card` from `pool_` to `cell`. `Unplace()` undoes it.
+  void Place(int cell, int card);
+  void Unplace(int cell, int card);
+
+  /** * * * * * * * * *
+   * Parallel search *
+   ** * * * * * * * * */
+
+  // PileupPokerSolver::Task
+  //
+  // A branch of the search to be handed to a worker: a choice of discards and
+  // the cards placed in the first cells of `kCellOrder`, with its upper bound.
+  struct Task {
+    uint32_t discards;
+    std::vector<int> cards;
+    int bound;
+  };
+
+  // PileupPokerSolver::CollectTasks()
+  //
+  // Appends to `tasks` every branch at depth `Parameters::parallel_depth`
+  // under the current one, in the order that `SearchGrid()` would visit them.
+  void CollectTasks(int depth, uint32_t discards, std::vector<int> &prefix,
+                    std::vector<Task> &tasks);
+
+  // PileupPokerSolver::SearchInParallel()
+  //
+  // Does the work of searching each of `discards`, in order, on
+  // `Parameters::num_threads` threads. Each worker has its own copy of the
+  // search state and shares the tables. Results are merged in task order, so
+  // that ties go to the same layout a serial search would have found first.
+  void SearchInParallel(const std::vector<uint32_t> &discards);
+
+  /** * * * * * * * * * *
+   * Symmetry breaking *
+   ** * * * * * * * * * */
+
+  // PileupPokerSolver::Symmetry
+  //
+  // A symmetry of the deal: a permutation of the grid that maps lines onto
+  // lines of the same kind, plus a relabeling of suits that maps the deal onto
+  // itself. `sources[cell]` is the cell whose card moves to `cell`, and
+  // `cards[card]` is what `card` becomes.
+  struct Symmetry {
+    std::array<int, 16> sources;
+    std::array<int, 20> cards;
+  };
+
+  // PileupPokerSolver::FindSymmetries()
+  //
+  // Fills `symmetries_` with every symmetry of `cards_` but the identity.
+  void FindSymmetries();
+
+  // PileupPokerSolver::IsCanonical()
+  //
+  // After a card is placed at `depth` of `kCellOrder`, checks the layout
+  // against its image under each symmetry in `ties_[depth]`, and fills
+  // `ties_[depth + 1]` with those it still ties. Returns false if some image
+  // is lesser, in which case the layout need not be searched.
+  bool IsCanonical(int depth);
+
+  /** * * * * * * * *
+   * Scoring bounds *
+   ** * * * * * * * */
+
+  // PileupPokerSolver::LineBound()
+  //
+  // Returns the best score that the cards in `line` can reach once the rest of
+  // it is filled from `pool_`, or its exact score if it is already full.
+  int LineBound(uint32_t line) const;
+
+  // PileupPokerSolver::UpperBound()
+  //
+  // Returns an upper bound on the score of any layout that extends the current
+  // one. Each open line is bounded by `LineBound()`, and each direction's open
+  // lines together by `Tables::partition_scores`, since their cards are
+  // disjoint.
+  int UpperBound() const;
+
+  /** * * * * * * *
+   * Member data *
+   ** * * * * * * */
+
+  std::vector<Card> cards_;
+  const Parameters params_;
+  std::vector<Symmetry> symmetries_;
+
+  // Each of these is indexed by a bitmask of indices into `cards_`.
+  // `hand_scores` holds the score of each 4-card hand. `best_hands` holds the
+  // score of the best hand within each set of cards, and `partition_scores`
+  // the best total for splitting each set of 4n cards into n hands. They are
+  // never changed once built, so parallel workers share them.
+  struct Tables {
+    std::vector<int> hand_scores;
+    std::vector<int> best_hands;
+    std::vector<int> partition_scores;
+  };
+  std::shared_ptr<const Tables> tables_;
+
+  // The state of the search. `layout_` holds the index of the card in each
+  // cell, or -1. `lines_` holds the cards in each row, then each column, then
+  // the corners. The `pool_*` members describe the grid cards not yet placed:
+  // `pool_ranks_` counts them by rank, and `pool_suits_` holds a bitmask of
+  // their ranks for each suit.
+  std::array<int, 20> layout_;
+  std::array<uint32_t, 9> lines_;
+  uint32_t pool_ = 0;
+  std::array<int, 14> pool_ranks_;
+  std::array<uint16_t, 4> pool_suits_;
+  int discard_score_ = 0;
+
+  // `ties_[depth]` holds each symmetry whose image of the layout has so far
+  // matched it, at each position of `kCellOrder` before the paired one, with
+  // `depth` cards placed.
+  std::array<std::vector<std::pair<int, int>>, 17> ties_;
+
+  std::array<int, 20> best_layout_;
+  int best_score_ = -1;
+
+  // When searching in parallel, the best score found by any worker.
+  std::atomic<int> *shared_best_score_ = nullptr;
 };
 
 }  // namespace puzzmo
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,69 @@
+#include "pile_up_poker_solver.h"
+
+#include <utility>
+#include <vector>
+
+#include "absl/status/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "src/pileuppoker/test_cards.h"
+
+namespace puzzmo {
+namespace {
+
+using absl_testing::IsOk;
+
+TEST(PileupPokerSolverTest, Score) {
+  EXPECT_EQ(PileupPokerSolver::Score(BestTestLayout()),
+            3 * 80 + 180 + 180 + 5 + 125 + 60 + 2 * 450 + 3 * 325);
+
+  // Swapping the 7 and the jack spoils the first and third rows, the first
+  // column and the corners, so the discards no longer count either.
+  std::vector<Card> layout = BestTestLayout();
+  std::swap(layout[0], layout[9]);
+  EXPECT_EQ(PileupPokerSolver::Score(layout), 80 + 180 + 5 + 125 + 60);
+}
+
+TEST(PileupPokerSolverTest, SolveFindsOptimum) {
+  PileupPokerSolver solver(TestDeal());
+  absl::StatusOr<std::vector<Card>> layout = solver.Solve();
+  ASSERT_THAT(layout, IsOk());
+  EXPECT_EQ(solver.best_score(), 2665);
+  EXPECT_EQ(PileupPokerSolver::Score(*layout), solver.best_score());
+  EXPECT_THAT(*layout, testing::UnorderedElementsAreArray(TestDeal()));
+}
+
+TEST(PileupPokerSolverTest, BreakingSymmetriesKeepsOptimum) {
+  PileupPokerSolver reduced(TestDeal());
+  ASSERT_THAT(reduced.Solve(), IsOk());
+  PileupPokerSolver unreduced(TestDeal(), {.break_symmetries = false});
+  ASSERT_THAT(unreduced.Solve(), IsOk());
+  EXPECT_EQ(reduced.best_score(), unreduced.best_score());
+
+  // Every relabeling of suits maps this deal onto itself. The unreduced search
+  // takes half a minute to confirm the optimum, so it is hardcoded here.
+  PileupPokerSolver suited(
+      Cards({"9S", "9H", "9C", "9D", "TS", "TH", "TC", "TD", "JS", "JH",
+             "JC", "JD", "QS", "QH", "QC", "QD", "KS", "KH", "KC", "KD"}));
+  absl::StatusOr<std::vector<Card>> layout = suited.Solve();
+  ASSERT_THAT(layout, IsOk());
+  EXPECT_EQ(suited.best_score(), 4195);
+  EXPECT_EQ(PileupPokerSolver::Score(*layout), 4195);
+}
+
+TEST(PileupPokerSolverTest, ThreadsFindSameLayout) {
+  PileupPokerSolver serial(TestDeal());
+  absl::StatusOr<std::vector<Card>> serial_layout = serial.Solve();
+  ASSERT_THAT(serial_layout, IsOk());
+  for (int parallel_depth : {0, 1, 2}) {
+    PileupPokerSolver parallel(
+        TestDeal(), {.num_threads = 4, .parallel_depth = parallel_depth});
+    absl::StatusOr<std::vector<Card>> parallel_layout = parallel.Solve();
+    ASSERT_THAT(parallel_layout, IsOk());
+    EXPECT_EQ(parallel.best_score(), serial.best_score());
+    EXPECT_EQ(*parallel_layout, *serial_layout);
+  }
+}
+
+}  // namespace
+}  // namespace puzzmo
@@ -0,0 +1,41 @@
+#include "test_cards.h"
+
+#include <string>
+#include <vector>
+
+namespace puzzmo {
+
+std::vector<Card> Cards(const std::vector<std::string> &strs) {
+  const std::string kRanks = "23456789TJQKA";
+  const std::string kSuits = "SHCD";
+  std::vector<Card> cards;
+  for (const std::string &str : strs) {
+    cards.push_back({.rank = static_cast<Rank>(kRanks.find(str[0]) + 1),
+                     .suit = static_cast<Suit>(kSuits.find(str[1]))});
+  }
+  return cards;
+}
+
+std::vector<Card> AllCards() {
+  std::vector<Card> cards;
+  for (int rank = kTwo; rank <= kAce; ++rank) {
+    for (int suit = kSpades; suit <= kDiamonds; ++suit)
+      cards.push_back({static_cast<Rank>(rank), static_cast<Suit>(suit)});
+  }
+  return cards;
+}
+
+std::vector<Card> TestDeal() {
+  return Cards({"6H", "6D", "6C", "7H", "8H", "8C", "8D", "8S", "9C", "9D",
+                "TD", "TS", "JH", "JC", "QC", "KH", "KC", "AC", "KD", "AH"});
+}
+
+std::vector<Card> BestTestLayout() {
+  return Cards({"JC", "9C", "6C", "AC",  //
+                "TD", "9D", "6D", "KD",  //
+                "KH", "7H", "6H", "AH",  //
+                "QC", "TS", "JH", "KC",  //
+                "8H", "8C", "8D", "8S"});
+}
+
+}  // namespace puzzmo
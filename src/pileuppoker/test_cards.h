@@ -0,0 +1,35 @@
+// -----------------------------------------------------------------------------
+// File: test_cards.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines helpers shared by the Pile-Up Poker tests: a parser
+// for cards written like "TD", and the deal in inputs/pile_up_poker_cards.txt.
+
+#ifndef PUZZMO_PILEUPPOKER_TEST_CARDS_H_
+#define PUZZMO_PILEUPPOKER_TEST_CARDS_H_
+
+#include <string>
+#include <vector>
+
+#include "src/pileuppoker/card.h"
+
+namespace puzzmo {
+
+// Parses strings like "TD" into cards.
+std::vector<Card> Cards(const std::vector<std::string> &strs);
+
+// Returns all 52 cards, in increasing order.
+std::vector<Card> AllCards();
+
+// Returns the deal in inputs/pile_up_poker_cards.txt, whose best layout
+// scores 2665.
+std::vector<Card> TestDeal();
+
+// Returns a layout of `TestDeal()` that scores 2665. Rows: flush, flush,
+// flush, straight. Columns: straight, pair, three of a kind, two pair.
+// Corners: straight flush. Discards: four of a kind.
+std::vector<Card> BestTestLayout();
+
+}  // namespace puzzmo
+
+#endif
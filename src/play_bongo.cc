@@ -1,10 +1,12 @@
 #include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -13,6 +15,7 @@
 #include "absl/strings/string_view.h"
 #include "bongo/dict.h"
 #include "bongo/gamestate.h"
+#include "bongo/search_cache.h"
 #include "bongo/solver.h"
 
 //-------
@@ -25,6 +28,10 @@ ABSL_FLAG(std::string, path_to_tile_file, "inputs/bongo_tiles.txt",
           "Space-delimited input file where each line contains a letter, the "
           "number of that letter, and the value of that latter.");
 
+ABSL_FLAG(std::string, path_to_cache_file, "",
+          "File in which to keep search results between runs. Runs on the "
+          "same board reuse them. Leave empty to disable caching.");
+
 //------------
 // Parameters
 
@@ -38,9 +45,22 @@ ABSL_FLAG(
     "The number to pass NMostValuableTiles, from which sets of 3 are chosen to "
     "make possible bonus words. Note that increasing this n scales by O(n^2).");
 
+ABSL_FLAG(int, threads, 1,
+          "The number of threads to search with. The result does not depend "
+          "on the number of threads.");
+
+ABSL_FLAG(int, widening_rounds, 0,
+          "The number of extra rounds to search once a solution is found, each "
+          "admitting one more tile for the bonus word and multiplier tiles.");
+
+ABSL_FLAG(bool, best_first, false,
+          "Whether to expand the most promising partial board first, instead "
+          "of searching depth-first. Ignores --threads.");
+
 using namespace puzzmo;
 using ::bongo::Dict;
 using ::bongo::Gamestate;
+using ::bongo::SearchCache;
 using ::bongo::Solver;
 using ::bongo::Technique;
 
@@ -101,9 +121,10 @@ absl::StatusOr<Gamestate> LoadStartingState() {
 
 }  // namespace
 
-// TODO: save output b/t runs to reduce duplicate work?
 // "childof"
 int main(int argc, const char *argv[]) {
+  absl::ParseCommandLine(argc, const_cast<char **>(argv));
+
   // Load the dictionary and the starting game state
   absl::StatusOr<Dict> dict = Dict::LoadFromFiles();
   if (!dict.ok()) {
@@ -139,7 +160,23 @@ int main(int argc, const char *argv[]) {
       {.techniques = {Technique::kFillBonusWordCells},
        .num_tiles_for_bonus_words = absl::GetFlag(FLAGS_tiles_for_bonus_words),
        .num_tiles_for_mult_cells =
-           absl::GetFlag(FLAGS_tiles_for_multiplier_tiles)});
+           absl::GetFlag(FLAGS_tiles_for_multiplier_tiles),
+       .num_threads = absl::GetFlag(FLAGS_threads),
+       .widening_rounds = absl::GetFlag(FLAGS_widening_rounds),
+       .best_first = absl::GetFlag(FLAGS_best_first)});
+  std::unique_ptr<SearchCache> cache;
+  if (const std::string path = absl::GetFlag(FLAGS_path_to_cache_file);
+      !path.empty()) {
+    absl::StatusOr<std::unique_ptr<SearchCache>> opened =
+        SearchCache::Open(path);
+    if (!opened.ok()) {
+      LOG(ERROR) << opened.status();
+      return 1;
+    }
+    cache = *std::move(opened);
+    bongo_solver.set_cache(cache.get());
+  }
+
   if (absl::StatusOr<Gamestate> solution = bongo_solver.Solve();
       !solution.ok()) {
     LOG(ERROR) << solution.status();
@@ -3,13 +3,22 @@
 #include <string>
 #include <vector>
 
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
 #include "absl/log/log.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "src/pileuppoker/pile_up_poker_solver.h"
 
+ABSL_FLAG(int, threads, 1,
+          "The number of threads to search with. The result does not depend "
+          "on the number of threads.");
+
 using namespace puzzmo;
 
 int main(int argc, const char *argv[]) {
+  absl::ParseCommandLine(argc, const_cast<char **>(argv));
+
   // Read in the board
   std::vector<Card> cards;
   std::ifstream cardfile("inputs/pile_up_poker_cards.txt");
@@ -81,14 +90,21 @@ int main(int argc, const char *argv[]) {
   }
   cardfile.close();
 
-  PileupPokerSolver solver(cards);
-  std::vector<Card> solution = solver.Solve();
+  PileupPokerSolver solver(cards,
+                           {.num_threads = absl::GetFlag(FLAGS_threads)});
+  absl::StatusOr<std::vector<Card>> solution = solver.Solve();
+  if (!solution.ok()) {
+    LOG(ERROR) << solution.status();
+    return 1;
+  }
 
-  for (int i = 0; i < 4; ++i) {
-    LOG(ERROR) << absl::StrCat("[", solution[4 * i].toString(), " ",
-                               solution[4 * i + 1].toString(), " ",
-                               solution[4 * i + 2].toString(), " ",
-                               solution[4 * i + 3].toString(), "]");
+  LOG(INFO) << "Optimal score: " << solver.best_score();
+  for (int i = 0; i < 5; ++i) {
+    LOG(INFO) << absl::StrCat(i < 4 ? "[" : "Discards: [",
+                              (*solution)[4 * i].toString(), " ",
+                              (*solution)[4 * i + 1].toString(), " ",
+                              (*solution)[4 * i + 2].toString(), " ",
+                              (*solution)[4 * i + 3].toString(), "]");
   }
   return 0;
 }
\ No newline at end of file
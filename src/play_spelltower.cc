@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
 #include "absl/log/log.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
@@ -36,6 +37,10 @@ ABSL_FLAG(bool, solve_with_one_long_word, true,
           "Find and print the possible word with the highest multiplier to the "
           "command line.");
 
+ABSL_FLAG(int, endgame_threshold, 16,
+          "Once this many tiles or fewer remain, stop solving greedily and "
+          "search the rest of the board exhaustively.");
+
 namespace {
 
 //---------
@@ -92,11 +97,14 @@ void PrintCurrentOptions(const Solver &solver) {
 // main
 
 int main(int argc, const char *argv[]) {
+  absl::ParseCommandLine(argc, const_cast<char **>(argv));
+
   absl::StatusOr<Solver> solver = LoadSolver();
   if (!solver.ok()) {
     LOG(ERROR) << solver.status();
     return 1;
   }
+  solver->set_endgame_threshold(absl::GetFlag(FLAGS_endgame_threshold));
 
   if (absl::GetFlag(FLAGS_print_current_options)) {
     solver->FillWordCache();
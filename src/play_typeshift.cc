@@ -1,110 +1,77 @@
 #include <algorithm>
-#include <fstream>
-#include <sstream>
 #include <string>
 #include <vector>
 
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
 #include "absl/log/log.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_join.h"
-#include "src/shared/dictionary_utils.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "src/typeshift/board.h"
+#include "src/typeshift/solver.h"
 
 using namespace puzzmo;
+using ::puzzmo::typeshift::Board;
+using ::puzzmo::typeshift::Solution;
+using ::puzzmo::typeshift::Solver;
 
-using TypeshiftBoard = std::vector<absl::flat_hash_set<char>>;
+ABSL_FLAG(std::string, typeshift_boards_file_path,
+          "inputs/typeshift_board.txt",
+          "Path to the input file containing one or more boards. Each line "
+          "holds the letters of one column, and boards are separated by blank "
+          "lines.");
 
-namespace {
-
-void DFS(std::shared_ptr<TrieNode> node, int i, const TypeshiftBoard &board,
-         std::vector<std::string> &words) {
-  if (node == nullptr) {
-    return;
-  }
-
-  if (node->word != nullptr) {
-    words.push_back(*node->word);
-    return;  // All words are of the same length
-  }
-
-  for (const char c : board[i]) {
-    std::shared_ptr<TrieNode> child = node->children[c - 'a'];
-    DFS(child, i + 1, board, words);
-  }
-}
-
-int UnusedLetters(const std::string &word, const TypeshiftBoard &board) {
-  int new_letters = 0;
-  for (int i = 0; i < board.size(); ++i) {
-    if (board[i].contains(word[i])) {
-      ++new_letters;
-    }
-  }
-  return new_letters;
-}
-
-}  // namespace
+ABSL_FLAG(absl::Duration, typeshift_time_limit, absl::Seconds(1),
+          "How long to search each board before settling for the best "
+          "solution found so far.");
 
 int main(int argc, const char *argv[]) {
-  // Read in the board
-  TypeshiftBoard board;
-  std::ifstream boardfile("inputs/typeshift_board.txt");
-  if (!boardfile.is_open()) {
-    LOG(ERROR) << "Error: Could not open typeshift_board.txt";
+  absl::ParseCommandLine(argc, const_cast<char **>(argv));
+
+  absl::StatusOr<std::vector<Board>> boards = typeshift::ReadBoardsFromFile(
+      absl::GetFlag(FLAGS_typeshift_boards_file_path));
+  if (!boards.ok()) {
+    LOG(ERROR) << boards.status();
     return 1;
   }
-  int word_length = 0;
-  int total_letters = 0;
-  std::string line;
-  while (std::getline(boardfile, line)) {
-    ++word_length;
-    absl::flat_hash_set<char> row;
-    std::istringstream iss(line);
-    char c;
-    while (iss >> c) {
-      ++total_letters;
-      row.insert(c);
-    }
-    board.push_back(row);
-  }
-  boardfile.close();
 
-  // Read in the dictionary
-  absl::StatusOr<std::vector<std::string>> words = ReadDictionaryFileToVector(
-      {.min_letters = word_length, .max_letters = word_length});
-  if (!words.ok()) {
-    LOG(ERROR) << words.status();
+  // Load the dictionary once, for every board.
+  absl::Time start = absl::Now();
+  absl::StatusOr<Solver> solver = Solver::CreateSolverWithPuzzmoWords(
+      {.time_limit = absl::GetFlag(FLAGS_typeshift_time_limit)});
+  if (!solver.ok()) {
+    LOG(ERROR) << solver.status();
     return 1;
   }
-  std::shared_ptr<TrieNode> dict = CreateDictionaryTrie(*words);
+  LOG(INFO) << "Loaded dictionary in " << absl::Now() - start;
 
-  std::vector<std::string> answers;
-  DFS(dict, 0, board, answers);
+  absl::Duration total_latency, max_latency;
+  for (const Board &board : *boards) {
+    start = absl::Now();
+    absl::StatusOr<Solution> solution = solver->Solve(board);
+    const absl::Duration latency = absl::Now() - start;
+    total_latency += latency;
+    max_latency = std::max(max_latency, latency);
 
-  absl::flat_hash_set<std::string> best_set;
-  for (int i = 0; i < 20; ++i) {
-    absl::flat_hash_set<std::string> temp_set;
-    TypeshiftBoard temp_board = board;
-    int temp_letters = total_letters;
-    while (temp_letters > 0) {
-      // Ensure that the first element in answers will use the most unused
-      // letters.
-      std::nth_element(answers.begin(), answers.begin(), answers.end(),
-                       [temp_board](std::string a, std::string b) {
-                         return UnusedLetters(a, temp_board) >
-                                UnusedLetters(b, temp_board);
-                       });
-      temp_set.insert(answers[0]);
-      temp_letters -= UnusedLetters(answers[0], temp_board);
-      for (int i = 0; i < word_length; ++i) {
-        temp_board[i].erase(answers[0][i]);
-      }
-    }
-    if (best_set.empty() || temp_set.size() < best_set.size()) {
-      best_set = temp_set;
+    LOG(INFO) << board.ToString();
+    if (!solution.ok()) {
+      LOG(ERROR) << solution.status();
+      continue;
     }
+    LOG(INFO) << absl::StrJoin(solution->words, ", ");
+    LOG(INFO) << (solution->optimal
+                      ? "No fewer words can use every letter."
+                      : "The time limit ran out before this could be proven "
+                        "the fewest words.");
+    LOG(INFO) << "Solved in " << latency;
+  }
+  if (boards->size() > 1) {
+    LOG(INFO) << "Solved " << boards->size() << " boards in " << total_latency
+              << " (mean " << total_latency / boards->size() << ", max "
+              << max_latency << ")";
   }
-
-  LOG(INFO) << absl::StrJoin(best_set, ", ");
 
   return 0;
-}
\ No newline at end of file
+}
@@ -102,7 +102,7 @@ const absl::flat_hash_set<std::string> FindMatchesInAnagramDictionary(
 }
 
 const std::shared_ptr<TrieNode> CreateDictionaryTrie(
-    const std::vector<std::string> words) {
+    const std::vector<std::string> &words) {
   std::shared_ptr<TrieNode> dict = std::make_shared<TrieNode>();
   for (const auto &word : words) {
     if (word.length() < 3) continue;
@@ -52,9 +52,11 @@ const absl::flat_hash_set<std::string> FindMatchesInAnagramDictionary(
         dict,
     const LetterCount &lc, absl::string_view rgx);
 
-// Add one or more words to the trie.
+// Add one or more words to the trie. Each node's `word` points into `words`
+// rather than holding a copy, so `words` must outlive the trie and must not be
+// modified while the trie is in use.
 const std::shared_ptr<TrieNode> CreateDictionaryTrie(
-    const std::vector<std::string> words);
+    const std::vector<std::string> &words);
 
 }  // namespace puzzmo
 
@@ -0,0 +1,14 @@
+#include "fingerprint.h"
+
+namespace puzzmo {
+
+uint64_t Fingerprint(absl::string_view s) {
+  uint64_t hash = 0xcbf29ce484222325;
+  for (char c : s) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+}  // namespace puzzmo
@@ -0,0 +1,24 @@
+// -----------------------------------------------------------------------------
+// File: fingerprint.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines a stable hash for strings. Unlike `absl::Hash`, its
+// output does not change between runs, so it is safe to write to disk.
+
+#ifndef PUZZMO_SHARED_FINGERPRINT_H_
+#define PUZZMO_SHARED_FINGERPRINT_H_
+
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+
+namespace puzzmo {
+
+// puzzmo::Fingerprint()
+//
+// Returns the 64-bit FNV-1a hash of `s`.
+uint64_t Fingerprint(absl::string_view s);
+
+}  // namespace puzzmo
+
+#endif
@@ -0,0 +1,15 @@
+#include "fingerprint.h"
+
+#include "gtest/gtest.h"
+
+namespace puzzmo {
+namespace {
+
+TEST(FingerprintTest, MatchesKnownValues) {
+  EXPECT_EQ(Fingerprint(""), 0xcbf29ce484222325);
+  EXPECT_EQ(Fingerprint("a"), 0xaf63dc4c8601ec8c);
+  EXPECT_NE(Fingerprint("ab"), Fingerprint("ba"));
+}
+
+}  // namespace
+}  // namespace puzzmo
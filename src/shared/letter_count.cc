@@ -32,7 +32,7 @@ void nCk(int start_at, int k, std::string &current, absl::string_view str,
     combinations.insert(current);
     return;
   }
-  for (int i = start_at; i < str.size() - (k - 1); ++i) {
+  for (int i = start_at; i + k <= str.size(); ++i) {
     current.push_back(str[i]);
     nCk(i + 1, k - 1, current, str, combinations);
     current.pop_back();
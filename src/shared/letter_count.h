@@ -9,6 +9,7 @@
 #ifndef PUZZMO_SHARED_LETTERCOUNT_H_
 #define PUZZMO_SHARED_LETTERCOUNT_H_
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -32,7 +33,7 @@ class LetterCount {
   // Constructors
 
   // An empty `LetterCount` will have a count of 0 for each letter.
-  LetterCount() : counts_(26) {};
+  LetterCount() : counts_{} {};
 
   // When a `LetterCount` is created from a string of chars, all uppercase
   // letters in the string are first cast to lowercase, and all non-letters in
@@ -46,7 +47,9 @@ class LetterCount {
   //
   // Returns a vector in which index `c - 'a'` contains the number of `c`s
   // contained in this `LetterCount`.
-  std::vector<int> counts() const { return counts_; }
+  std::vector<int> counts() const {
+    return std::vector<int>(counts_.begin(), counts_.end());
+  }
 
   // LetterCount::operator[]
   //
@@ -174,7 +177,9 @@ class LetterCount {
   //---------
   // Members
 
-  std::vector<int> counts_;
+  // Fixed-size so that a `LetterCount` is trivially copyable and never
+  // allocates.
+  std::array<int, 26> counts_;
 
   //------------------
   // Abseil functions
@@ -122,6 +122,7 @@ TEST(LetterCountTest, CombinationsOfSize) {
                   StrEq("wwwx"), StrEq("wwwy"), StrEq("wwwz"), StrEq("wwxx"),
                   StrEq("wwxy"), StrEq("wwxz"), StrEq("wwyz"), StrEq("wxxy"),
                   StrEq("wxxz"), StrEq("wxyz"), StrEq("xxyz")));
+  EXPECT_THAT(lc.CombinationsOfSize(8), testing::IsEmpty());
 }
 
 TEST(LetterCountTest, Contains) {
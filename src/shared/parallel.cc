@@ -0,0 +1,31 @@
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace puzzmo {
+
+void ParallelFor(int num_tasks, int num_threads,
+                 absl::FunctionRef<void(int worker, int task)> fn) {
+  num_threads = std::min(num_threads, num_tasks);
+  if (num_threads <= 1) {
+    for (int task = 0; task < num_tasks; ++task) fn(0, task);
+    return;
+  }
+
+  std::atomic<int> next_task = 0;
+  auto work = [&](int worker) {
+    for (int task = next_task++; task < num_tasks; task = next_task++)
+      fn(worker, task);
+  };
+
+  std::vector<std::thread> threads;
+  for (int worker = 1; worker < num_threads; ++worker)
+    threads.emplace_back(work, worker);
+  work(0);
+  for (std::thread &thread : threads) thread.join();
+}
+
+}  // namespace puzzmo
@@ -0,0 +1,31 @@
+// -----------------------------------------------------------------------------
+// File: parallel.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines a small helper for spreading independent pieces of
+// work, such as the top-level branches of a search, across several threads.
+
+#ifndef PUZZMO_SHARED_PARALLEL_H_
+#define PUZZMO_SHARED_PARALLEL_H_
+
+#include "absl/functional/function_ref.h"
+
+namespace puzzmo {
+
+// puzzmo::ParallelFor()
+//
+// Calls `fn(worker, task)` exactly once for each `task` in [0, `num_tasks`),
+// using up to `num_threads` threads, and returns once every call has finished.
+// Tasks are handed out in increasing order to whichever worker frees up first,
+// so a few expensive tasks do not leave the other threads idle. `worker` is in
+// [0, `num_threads`) and is unique to the calling thread, so `fn` can index
+// per-worker state with it without locking.
+//
+// If `num_threads` is 1 or less, all tasks are run in order on the calling
+// thread.
+void ParallelFor(int num_tasks, int num_threads,
+                 absl::FunctionRef<void(int worker, int task)> fn);
+
+}  // namespace puzzmo
+
+#endif
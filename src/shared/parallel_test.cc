@@ -0,0 +1,37 @@
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace puzzmo {
+namespace {
+
+TEST(ParallelTest, RunsEveryTaskOnce) {
+  for (int num_threads : {0, 1, 3, 8}) {
+    std::vector<std::atomic<int>> runs(100);
+    std::atomic<bool> bad_worker = false;
+    ParallelFor(runs.size(), num_threads, [&](int worker, int task) {
+      if (worker < 0 || worker >= std::max(num_threads, 1)) bad_worker = true;
+      ++runs[task];
+    });
+    EXPECT_FALSE(bad_worker);
+    for (const std::atomic<int> &r : runs) EXPECT_EQ(r, 1);
+  }
+}
+
+TEST(ParallelTest, SerialRunsInOrder) {
+  std::vector<int> order;
+  ParallelFor(5, 1, [&](int, int task) { order.push_back(task); });
+  EXPECT_THAT(order, testing::ElementsAre(0, 1, 2, 3, 4));
+}
+
+TEST(ParallelTest, NoTasks) {
+  ParallelFor(0, 4, [](int, int) { FAIL(); });
+}
+
+}  // namespace
+}  // namespace puzzmo
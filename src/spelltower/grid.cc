@@ -29,6 +29,7 @@ Grid::Grid(const std::vector<std::string>& grid_strings)
       (void)column_letter_counts_[c].AddLetter(tile->letter());
     }
   }
+  UpdateMasks();
 }
 
 std::vector<std::shared_ptr<Tile>> Grid::row(int row) const {
@@ -41,17 +42,7 @@ std::vector<std::shared_ptr<Tile>> Grid::row(int row) const {
 }
 
 int Grid::ScorePath(const Path& path) const {
-  std::vector<std::shared_ptr<Tile>> affected_tiles = TilesRemovedBy(path);
-
-  // Sum the values of all affected points, multiply by path.size(), and
-  // multiply again by the number of stars used (plus one).
-  int score = 0;
-  for (const std::shared_ptr<Tile>& tile : affected_tiles) {
-    if (tile == nullptr || tile->is_blank()) continue;
-    score += tile->value();
-  }
-  score *= path.size();
-  return score *= (1 + path.star_count());
+  return ScoreFootprint(FootprintOf(path), path.size(), path.star_count());
 }
 
 bool Grid::AlmostThere() const {
@@ -141,44 +132,15 @@ std::vector<std::vector<std::shared_ptr<Tile>>> Grid::TilesBeneathEachPathTile(
   return v;
 }
 
-absl::flat_hash_set<Point> Grid::PointsAffectedBy(
-    const std::shared_ptr<Tile>& tile) const {
-  if (tile == nullptr) return {};
-
-  absl::flat_hash_set<Point> affected_points =
-      tile->coords().VonNeumannNeighbors();
-  absl::erase_if(affected_points,
-                 [*this](const Point& p) { return !IsPointInRange(p); });
-
-  return affected_points;
-}
-
 std::vector<Point> Grid::PointsRemovedBy(const Path& path) const {
-  absl::flat_hash_set<Point> affected_points;
-  for (const std::shared_ptr<Tile>& tile : path.tiles()) {
-    // Because `tile` is coming from `path`, we know it isn't `nullptr`.
-    affected_points.insert(tile->coords());
-
-    // If `tile` is rare, we need to include everything in the row.
-    if (tile->is_rare()) {
-      for (int c = 0; c < kNumCols; ++c)
-        if (Point p = {tile->row(), c}; IsPointInRange(p))
-          affected_points.insert(p);
-    }
-
-    // We want to include any blank tiles that are von Neumann neighbors
-    // regardless, but if `path` has 5 or more tiles, we keep the letters as
-    // well.
-    absl::flat_hash_set<Point> points_affected_by = PointsAffectedBy(tile);
-    for (const Point& p : points_affected_by) {
-      if (path.size() < 5 && !tiles_[p.col][p.row]->is_blank()) continue;
-      affected_points.insert(p);
+  Mask removed = RemovalMask(FootprintOf(path), path.size());
+  std::vector<Point> vec;
+  for (int c = 0; c < kNumCols; ++c) {
+    for (int r = kNumRows - 1; r >= 0; --r) {
+      Point p = {r, c};
+      if (removed.test(MaskIndex(p))) vec.push_back(p);
     }
   }
-  std::vector<Point> vec(affected_points.begin(), affected_points.end());
-  std::sort(vec.begin(), vec.end(), [](const Point& lhs, const Point& rhs) {
-    return lhs.col != rhs.col ? lhs.col < rhs.col : lhs.row > rhs.row;
-  });
   return vec;
 }
 
@@ -195,6 +157,84 @@ std::vector<std::shared_ptr<Tile>> Grid::TilesRemovedBy(
   return removed_tiles;
 }
 
+Grid::Mask Grid::MaskOf(const std::vector<std::shared_ptr<Tile>>& tiles) {
+  Mask mask;
+  for (const std::shared_ptr<Tile>& tile : tiles)
+    if (tile != nullptr) mask.set(MaskIndex(tile->coords()));
+  return mask;
+}
+
+Grid::Mask Grid::RemovalMask(const Path& path) const {
+  return RemovalMask(FootprintOf(path), path.size());
+}
+
+Grid::Footprint Grid::FootprintOf(const Path& path) const {
+  Footprint footprint;
+  for (const std::shared_ptr<Tile>& tile : path.tiles())
+    footprint = ExtendFootprint(footprint, tile);
+  return footprint;
+}
+
+Grid::Footprint Grid::ExtendFootprint(const Footprint& footprint,
+                                      const std::shared_ptr<Tile>& tile) const {
+  Footprint extended = footprint;
+  auto splash = [&](int i) {
+    if (!occupied_.test(i) || extended.splashed.test(i)) return;
+    extended.splashed.set(i);
+    extended.splashed_value += values_[i];
+  };
+  auto remove = [&](int i) {
+    splash(i);
+    if (!occupied_.test(i) || extended.removed.test(i)) return;
+    extended.removed.set(i);
+    extended.removed_value += values_[i];
+  };
+
+  const auto [row, col] = tile->coords();
+  remove(MaskIndex(tile->coords()));
+
+  // If `tile` is rare, everything in its row goes with it.
+  if (tile->is_rare())
+    for (int c = 0; c < kNumCols; ++c) remove(MaskIndex({row, c}));
+
+  // Von Neumann neighbors are only removed outright if they are blank, or if
+  // the path is long enough; `RemovalMask()` sorts that out later.
+  if (row > 0) splash(MaskIndex({row - 1, col}));
+  if (row < kNumRows - 1) splash(MaskIndex({row + 1, col}));
+  if (col > 0) splash(MaskIndex({row, col - 1}));
+  if (col < kNumCols - 1) splash(MaskIndex({row, col + 1}));
+  return extended;
+}
+
+Grid::Mask Grid::RemovalMask(const Footprint& footprint, int path_size) const {
+  if (path_size >= 5) return footprint.splashed;
+  return footprint.removed | (footprint.splashed & blanks_);
+}
+
+int Grid::ScoreFootprint(const Footprint& footprint, int path_size,
+                         int star_count) {
+  // Blank tiles are worth nothing, so only long paths score their splash.
+  int score =
+      path_size >= 5 ? footprint.splashed_value : footprint.removed_value;
+  return score * path_size * (1 + star_count);
+}
+
+void Grid::UpdateMasks() {
+  occupied_.reset();
+  blanks_.reset();
+  values_.fill(0);
+  for (int c = 0; c < kNumCols; ++c) {
+    for (int r = 0; r < kNumRows; ++r) {
+      const std::shared_ptr<Tile>& tile = tiles_[c][r];
+      if (tile == nullptr) continue;
+      int i = MaskIndex({r, c});
+      occupied_.set(i);
+      if (tile->is_blank()) blanks_.set(i);
+      values_[i] = tile->value();
+    }
+  }
+}
+
 std::vector<std::string> Grid::AsCharMatrix() const {
   std::vector<std::string> v;
   for (int r = 0; r < kNumRows; ++r) {
@@ -322,6 +362,7 @@ absl::Status Grid::ClearPath(const Path& path) {
     tile->set_is_on_grid(false);
     column.push_back(nullptr);
   }
+  UpdateMasks();
   return absl::OkStatus();
 }
 
@@ -369,6 +410,7 @@ absl::Status Grid::RevertLastClear() {
   }
 
   tile_removal_history_.pop_back();
+  UpdateMasks();
   return absl::OkStatus();
 }
 
@@ -9,6 +9,8 @@
 #ifndef PUZZMO_SPELLTOWER_GRID_H_
 #define PUZZMO_SPELLTOWER_GRID_H_
 
+#include <array>
+#include <bitset>
 #include <memory>
 #include <vector>
 
@@ -35,6 +37,9 @@ namespace puzzmo::spelltower {
 // board to all of the tiles that contain it.
 class Grid {
  public:
+  static constexpr int kNumRows = 13;
+  static constexpr int kNumCols = 9;
+
   //-------------
   // Constructor
 
@@ -150,6 +155,11 @@ class Grid {
   // Returns `true` if all tiles have been cleared from the grid.
   bool FullClear() const;
 
+  // Grid::NumTiles()
+  //
+  // Returns the number of tiles, including blank tiles, left on the grid.
+  int NumTiles() const { return occupied_.count(); }
+
   // Grid::ScoreBonuses()
   //
   // Returns the bonus points that this grid qualifies for in its current state.
@@ -207,6 +217,78 @@ class Grid {
   // highest to lowest.
   std::vector<std::shared_ptr<Tile>> TilesRemovedBy(const Path &path) const;
 
+  //----------
+  // Bitmasks
+
+  // Grid::Mask
+  //
+  // A bitmask with one bit for every space on the grid. Sets of tiles that are
+  // compared against each other over and over, such as the tiles of a goal
+  // path and the tiles removed by each candidate word, are far cheaper to
+  // intersect this way than by searching vectors of tiles.
+  using Mask = std::bitset<kNumRows * kNumCols>;
+
+  // Grid::MaskIndex()
+  //
+  // Returns the bit that represents `p` in a `Mask`. Bits are ordered by
+  // column, then by row, so each column occupies a contiguous run of bits.
+  static int MaskIndex(const Point &p) { return p.col * kNumRows + p.row; }
+
+  // Grid::MaskOf()
+  //
+  // Returns a `Mask` with the bit set for the current position of each tile in
+  // `tiles`. Null tiles are skipped.
+  static Mask MaskOf(const std::vector<std::shared_ptr<Tile>> &tiles);
+
+  // Grid::RemovalMask()
+  //
+  // Returns the `Mask` of every tile that will be removed if `path` is played.
+  // Equivalent to `MaskOf(TilesRemovedBy(path))`.
+  Mask RemovalMask(const Path &path) const;
+
+  //----------------
+  // Scoring kernel
+
+  // Grid::Footprint
+  //
+  // The tiles a path will remove, built up one tile at a time. `removed` holds
+  // the path's tiles and every tile in a row cleared by a rare tile, while
+  // `splashed` additionally holds every tile that is a von Neumann neighbor of
+  // the path. Each mask carries the summed value of the tiles in it, so a path
+  // can be rescored in constant time whenever it grows by one tile.
+  struct Footprint {
+    Mask removed;
+    Mask splashed;
+    int removed_value = 0;
+    int splashed_value = 0;
+  };
+
+  // Grid::FootprintOf()
+  //
+  // Returns the `Footprint` of `path`, built by extending an empty footprint
+  // with each of its tiles in turn.
+  Footprint FootprintOf(const Path &path) const;
+
+  // Grid::ExtendFootprint()
+  //
+  // Returns `footprint` with `tile` added to the path it describes.
+  Footprint ExtendFootprint(const Footprint &footprint,
+                            const std::shared_ptr<Tile> &tile) const;
+
+  // Grid::RemovalMask()
+  //
+  // Returns the `Mask` of every tile that will be removed by a path of
+  // `path_size` tiles with the given `footprint`: every splashed tile if the
+  // path is five or more tiles long, and only the blank ones otherwise.
+  Mask RemovalMask(const Footprint &footprint, int path_size) const;
+
+  // Grid::ScoreFootprint()
+  //
+  // Returns the score of a path of `path_size` tiles, `star_count` of which are
+  // stars, with the given `footprint`. Equivalent to `ScorePath()`.
+  static int ScoreFootprint(const Footprint &footprint, int path_size,
+                            int star_count);
+
   //----------
   // Mutators
 
@@ -234,18 +316,17 @@ class Grid {
   // A helper method for `Grid::VisualizePath()` and `AbslStringify()`.
   std::vector<std::string> AsCharMatrix() const;
 
-  // Grid::PointsAffectedBy()
-  //
-  // Returns the von Neumann neighbors of `tile->coords()` that have tiles on
-  // them.
-  absl::flat_hash_set<Point> PointsAffectedBy(
-      const std::shared_ptr<Tile> &tile) const;
-
   // Grid::PointsRemovedBy()
   //
   // A helper method for `Grid::VisualizePath()` and `Grid::TilesRemovedBy()`.
   std::vector<Point> PointsRemovedBy(const Path &path) const;
 
+  // Grid::UpdateMasks()
+  //
+  // Recomputes `occupied_`, `blanks_`, and `values_` from `tiles_`. Called
+  // whenever tiles are added to or removed from the grid.
+  void UpdateMasks();
+
   //---------
   // Members
 
@@ -256,8 +337,12 @@ class Grid {
   std::vector<LetterCount> column_letter_counts_;
   std::vector<std::vector<std::shared_ptr<Tile>>> tile_removal_history_;
 
-  static constexpr int kNumRows = 13;
-  static constexpr int kNumCols = 9;
+  // Flattened copies of `tiles_` used by the scoring kernel, indexed by
+  // `MaskIndex()`.
+  Mask occupied_;
+  Mask blanks_;
+  std::array<int, kNumRows * kNumCols> values_;
+
   static constexpr char kEmptySpaceLetter = ' ';
   static constexpr char kAffectedSpaceLetter = '+';
 
@@ -143,6 +143,28 @@ TEST(GridTest, TilesRemovedBy) {
                   grid[{11, 6}], grid[{10, 6}], grid[{9, 6}], grid[{8, 6}]));
 }
 
+TEST(GridTest, RemovalMask) {
+  Grid grid({"nnnnnnn n", "mmmmmmm m", "lllllll l", "kkkkkkk k", "iiiijii i",
+             "hhhhhhhhh", "ggggggggg", "fffffffff", "eeeeeeeee", "ddddddddd",
+             "ccccccccc", "bbbbbbbbb", "aaaaaaaaa"});
+
+  Path short_path;
+  ASSERT_THAT(short_path.push_back({grid[{0, 0}], grid[{0, 1}], grid[{1, 2}]}),
+              IsOk());
+  EXPECT_EQ(grid.RemovalMask(short_path),
+            Grid::MaskOf(grid.TilesRemovedBy(short_path)));
+  EXPECT_EQ(grid.RemovalMask(short_path).count(), 3);
+  EXPECT_TRUE(grid.RemovalMask(short_path).test(Grid::MaskIndex({1, 2})));
+
+  Path path_with_rare_tile;
+  ASSERT_THAT(
+      path_with_rare_tile.push_back({grid[{6, 4}], grid[{7, 4}], grid[{8, 4}]}),
+      IsOk());
+  EXPECT_EQ(grid.RemovalMask(path_with_rare_tile),
+            Grid::MaskOf(grid.TilesRemovedBy(path_with_rare_tile)));
+  EXPECT_EQ(grid.RemovalMask(path_with_rare_tile).count(), 10);
+}
+
 TEST(GridTest, ClearPath) {
   Grid grid({"nnnnnnn n", "mmmmmmm m", "lllllll l", "kkkkkkk k", "iiiijii i",
              "hhhhhhhhh", "ggggggggg", "fffffffff", "eeeeeeeee", "ddddddddd",
@@ -255,6 +277,26 @@ TEST(GridTest, ScorePath) {
   EXPECT_EQ(grid.ScorePath(long_path), 220);
 }
 
+TEST(GridTest, ExtendFootprint) {
+  Grid grid({"nnnnnNn n", "mmmmmmm m", "lllllll l", "kkkkkkk k", "Iiiijii i",
+             "hhhhhhhhh", "ggggggggg", "fffffffff", "eeeeeeeee", "ddddddddd",
+             "ccccccccc", "bbBbbbbbb", "aaaaaaaaa"});
+
+  // Extending one tile at a time scores each prefix the same as `ScorePath()`.
+  Path path;
+  Grid::Footprint footprint;
+  for (const Point& p : std::vector<Point>{
+           {4, 5}, {5, 5}, {6, 5}, {7, 5}, {8, 5}, {9, 6}, {10, 6}}) {
+    ASSERT_THAT(path.push_back(grid[p]), IsOk());
+    footprint = grid.ExtendFootprint(footprint, grid[p]);
+    EXPECT_EQ(
+        Grid::ScoreFootprint(footprint, path.size(), path.star_count()),
+        grid.ScorePath(path));
+    EXPECT_EQ(grid.RemovalMask(footprint, path.size()),
+              Grid::MaskOf(grid.TilesRemovedBy(path)));
+  }
+}
+
 TEST(GridTest, VisualizePath) {
   Grid grid({"   e", "   vi", "  Iatp", " kd.dcHc", "enkolgscr", "ssrsaamfq"});
   Path path;
@@ -1,6 +1,7 @@
 #include "solver.h"
 
 #include <algorithm>
+#include <optional>
 
 #include "absl/container/btree_set.h"
 #include "absl/log/log.h"
@@ -11,15 +12,19 @@ namespace puzzmo::spelltower {
 namespace {
 
 constexpr absl::string_view kVerboseBestGoalWordLoop =
-    "Searching %d words of length %d for paths that use %d or more stars.";
+    "Searching %d candidate words with a possible multiplier of x%d.";
+constexpr absl::string_view kVerboseEndgame =
+    "Solving the endgame: %d tiles remain, worth at most %d more points.";
 constexpr absl::string_view kVerboseFoundPathForWord =
     "Found playable %d* path for \"%s\": %v";
 constexpr absl::string_view kVerboseLongestWord =
     "[%03d/%03d] Searching for a path for word \"%s\".";
 constexpr absl::string_view kVerboseThreeStarCouldBeBetter =
-    "A 3* word of length %d or higher would have a higher multiplier. "
-    "Continuing the search in case one can be found.";
+    "A word with a multiplier of x%d or higher would be better. Continuing the "
+    "search in case one can be found.";
 
+constexpr absl::string_view kEndgameRetraceError =
+    "Could not retrace the endgame solution from its memoized results.";
 constexpr absl::string_view kGoalPathNotPossible =
     "No longer possible--undoing the last word.";
 constexpr absl::string_view kNotEnoughStars =
@@ -87,6 +92,7 @@ absl::StatusOr<Solver> Solver::CreateSolverWithSerializedDict(
 
 absl::Status Solver::reset() {
   word_cache_.clear();
+  word_multiplicities_.clear();
   solution_.clear();
   snapshots_.clear();
   word_score_sum_ = 0;
@@ -113,6 +119,7 @@ absl::Status Solver::PlayWord(const Path& word) {
   }
   solution_.push_back(word);
   word_cache_.clear();
+  word_multiplicities_.clear();
   word_score_sum_ += word_score;
   return absl::OkStatus();
 }
@@ -127,6 +134,7 @@ absl::Status Solver::UndoLastPlay() {
   }
   word_score_sum_ -= grid_.ScorePath(solution_.back());
   word_cache_.clear();
+  word_multiplicities_.clear();
   solution_.pop_back();
   snapshots_.pop_back();
   return absl::OkStatus();
@@ -137,6 +145,7 @@ absl::Status Solver::UndoLastPlay() {
 absl::Status Solver::SolveGreedily() {
   FillWordCache();
   while (!word_cache_.empty()) {
+    if (grid_.NumTiles() <= endgame_threshold_) return SolveEndgame();
     auto& [score, highest_scoring_words] = *word_cache_.begin();
     Path word = *highest_scoring_words.begin();
     if (absl::Status s = PlayWord(word); !s.ok()) return s;
@@ -155,69 +164,156 @@ absl::Status Solver::SolveWithOneLongWord() {
   return SolveGreedily();
 }
 
+absl::Status Solver::SolveEndgame() {
+  absl::flat_hash_map<std::string, int> memo;
+  int points_left = EndgameDFS(memo);
+  LOG(INFO) << absl::StrFormat(kVerboseEndgame, grid_.NumTiles(), points_left);
+
+  // Retrace the best line of play through the memoized results.
+  while (points_left > grid_.ScoreBonuses()) {
+    FillWordCache();
+    // `PlayWord()` clears `word_cache_`, so copy the chosen path out first.
+    std::optional<Path> next;
+    int next_points_left = 0;
+    for (auto entry = word_cache_.begin(); entry != word_cache_.end() && !next;
+         ++entry) {
+      const auto& [score, paths] = *entry;
+      for (auto path = paths.begin(); path != paths.end() && !next; ++path) {
+        if (absl::Status s = grid_.ClearPath(*path); !s.ok()) return s;
+        int points_after = EndgameDFS(memo);
+        if (absl::Status s = grid_.RevertLastClear(); !s.ok()) return s;
+        if (score + points_after != points_left) continue;
+        next = *path;
+        next_points_left = points_after;
+      }
+    }
+    if (!next.has_value()) return absl::InternalError(kEndgameRetraceError);
+
+    if (absl::Status s = PlayWord(*next); !s.ok()) return s;
+    points_left = next_points_left;
+  }
+  return absl::OkStatus();
+}
+
 // Helpers
 
 absl::StatusOr<std::vector<Path>> Solver::BestPossibleGoalWord() {
   if (grid_.star_tiles().size() < 3)
     return absl::InvalidArgumentError(kNotEnoughStars);
 
-  // Get the parameters.
-  std::vector<LetterCount> column_lcs = grid_.column_letter_counts();
-  LetterCount letters_in_grid =
-      std::accumulate(column_lcs.begin(), column_lcs.end(), LetterCount());
-  std::string two_star_regex = grid_.NStarRegex(2);
-  std::string three_star_regex = grid_.NStarRegex(3);
+  absl::btree_map<int, absl::btree_set<std::string, Dict::LongerStrComp>,
+                  std::greater<int>>
+      candidates = GoalWordCandidates();
 
-  int min_word_len = 3;
+  int best_multiplier = 0;
   std::vector<Path> partial_solution;
-  // We start by casting a wide (2*) net until we get a path.
-  bool include_two_star_words = true;
-  for (int len = 28; len >= min_word_len; --len) {
-    // Get words of the appropriate length.
-    auto words_to_try = dict_.WordsMatchingParameters(
-        {.min_length = len,
-         .max_length = len,
-         .letter_superset = letters_in_grid,
-         .matching_regex =
-             include_two_star_words ? two_star_regex : three_star_regex});
-    LOG(INFO) << absl::StrFormat(kVerboseBestGoalWordLoop, words_to_try.size(),
-                                 len, include_two_star_words ? 2 : 3);
+  for (const auto& [multiplier, words] : candidates) {
+    // Candidates are ranked, so once no candidate could beat what we already
+    // have, we're done.
+    if (multiplier <= best_multiplier) break;
+    LOG(INFO) << absl::StrFormat(kVerboseBestGoalWordLoop, words.size(),
+                                 multiplier);
 
     int ct_for_logging = 0;
-    for (const std::string& word : words_to_try) {
+    for (const std::string& word : words) {
       LOG(INFO) << absl::StrFormat(kVerboseLongestWord, ++ct_for_logging,
-                                   words_to_try.size(), word);
+                                   words.size(), word);
 
-      // PHASE 1: 2* or 3*
-      if (include_two_star_words) {
-        absl::StatusOr<std::vector<Path>> s =
-            BestPossibleTwoStarPathForWord(word);
-        if (!s.ok()) continue;
-
-        partial_solution = *std::move(s);
-        int stars_in_goal_word = partial_solution.back().star_count();
-        LOG(INFO) << absl::StrFormat(kVerboseFoundPathForWord,
-                                     stars_in_goal_word, word, len);
-        if (stars_in_goal_word == 3) return partial_solution;
-        min_word_len = len * 3 / 4 + (len * 3 % 4 != 0);
-        LOG(INFO) << absl::StrFormat(kVerboseThreeStarCouldBeBetter,
-                                     min_word_len);
-      }
-
-      // PHASE 2: only 3*
-      else {
+      // A word with room for all three stars should try for them first.
+      const int len = word.length();
+      if (multiplier == len * 4) {
         absl::StatusOr<std::vector<Path>> s =
             BestPossibleThreeStarPathForWord(word);
-        if (!s.ok()) continue;
-        LOG(INFO) << absl::StrFormat(kVerboseFoundPathForWord, 3, word, len);
-        return *std::move(s);
+        if (s.ok()) {
+          LOG(INFO) << absl::StrFormat(kVerboseFoundPathForWord, 3, word,
+                                       s->back());
+          return *std::move(s);
+        }
       }
+      if (len * 3 <= best_multiplier) continue;
+
+      absl::StatusOr<std::vector<Path>> s = BestPossibleTwoStarPathForWord(word);
+      if (!s.ok()) continue;
+
+      int stars_in_goal_word = s->back().star_count();
+      LOG(INFO) << absl::StrFormat(kVerboseFoundPathForWord, stars_in_goal_word,
+                                   word, s->back());
+      if (stars_in_goal_word == 3) return *std::move(s);
+      best_multiplier = len * 3;
+      partial_solution = *std::move(s);
+      LOG(INFO) << absl::StrFormat(kVerboseThreeStarCouldBeBetter,
+                                   best_multiplier + 1);
     }
   }
   if (partial_solution.empty()) return absl::NotFoundError("No words found.");
   return partial_solution;
 }
 
+absl::btree_map<int, absl::btree_set<std::string, Dict::LongerStrComp>,
+                std::greater<int>>
+Solver::GoalWordCandidates() const {
+  // Star tiles are tracked individually, so take them out of the supply.
+  std::vector<std::shared_ptr<Tile>> stars = grid_.star_tiles();
+  std::vector<LetterCount> column_lcs = grid_.column_letter_counts();
+  std::vector<std::vector<int>> supply(column_lcs.size(), std::vector<int>(26));
+  for (int c = 0; c < column_lcs.size(); ++c)
+    for (char l = 'a'; l <= 'z'; ++l) supply[c][l - 'a'] = column_lcs[c].count(l);
+  for (const std::shared_ptr<Tile>& star : stars)
+    --supply[star->col()][star->letter() - 'a'];
+
+  std::string word;
+  absl::flat_hash_map<std::string, int> multipliers;
+  GoalWordCandidatesDFS(dict_.trie().root(), -1, 0, stars, supply, word,
+                        multipliers);
+
+  absl::btree_map<int, absl::btree_set<std::string, Dict::LongerStrComp>,
+                  std::greater<int>>
+      candidates;
+  for (const auto& [w, multiplier] : multipliers)
+    candidates[multiplier].insert(w);
+  return candidates;
+}
+
+void Solver::GoalWordCandidatesDFS(
+    const std::shared_ptr<TrieNode>& trie_node, int col, int stars_used,
+    const std::vector<std::shared_ptr<Tile>>& stars,
+    std::vector<std::vector<int>>& supply, std::string& word,
+    absl::flat_hash_map<std::string, int>& multipliers) const {
+  // Check for success.
+  int star_count = 0;
+  for (int i = 0; i < stars.size(); ++i) star_count += (stars_used >> i) & 1;
+  if (trie_node->is_word && word.length() >= 3 && star_count >= 2) {
+    int& multiplier = multipliers[word];
+    multiplier = std::max(multiplier, (int)word.length() * (1 + star_count));
+  }
+
+  // The first letter can come from any column; the rest must stay adjacent.
+  const int min_col = col < 0 ? 0 : std::max(col - 1, 0);
+  const int max_col =
+      col < 0 ? supply.size() - 1 : std::min(col + 1, (int)supply.size() - 1);
+  for (int l = 0; l < 26; ++l) {
+    const std::shared_ptr<TrieNode>& child = trie_node->children[l];
+    if (child == nullptr) continue;
+    word.push_back('a' + l);
+    for (int c = min_col; c <= max_col; ++c) {
+      if (supply[c][l] > 0) {
+        --supply[c][l];
+        GoalWordCandidatesDFS(child, c, stars_used, stars, supply, word,
+                              multipliers);
+        ++supply[c][l];
+      }
+      for (int i = 0; i < stars.size(); ++i) {
+        if ((stars_used >> i) & 1 || stars[i]->col() != c ||
+            stars[i]->letter() - 'a' != l)
+          continue;
+        GoalWordCandidatesDFS(child, c, stars_used | (1 << i), stars, supply,
+                              word, multipliers);
+      }
+    }
+    word.pop_back();
+  }
+}
+
 // BestPossiblePathForWord()
 absl::StatusOr<Path> Solver::BestPossiblePathForWord(
     absl::string_view word) const {
@@ -384,34 +480,132 @@ absl::StatusOr<std::vector<Path>> Solver::ThreeStarDFS(
 }
 
 void Solver::FillWordCache(
-    absl::btree_map<int, absl::btree_set<Path>, std::greater<int>>& cache) {
+    absl::btree_map<int, absl::btree_set<Path>, std::greater<int>>& cache,
+    absl::flat_hash_map<Path, int>* multiplicities) {
   if (!cache.empty()) return;
 
+  PathsByEffect paths;
   Path path;
   for (const std::vector<std::shared_ptr<Tile>>& column : grid_.tiles()) {
     for (const std::shared_ptr<Tile>& tile : column) {
       if (absl::Status s = path.push_back(tile); !s.ok()) continue;
       CacheDFS(dict_.trie().root()->children[tile->letter() - 'a'], path,
-               cache);
+               grid_.ExtendFootprint({}, tile), paths);
       path.pop_back();
     }
   }
+
+  for (const auto& [effect, representative] : paths) {
+    const auto& [rep_path, count] = representative;
+    cache[effect.first].insert(rep_path);
+    if (multiplicities != nullptr) (*multiplicities)[rep_path] = count;
+  }
 }
 
-void Solver::CacheDFS(
-    const std::shared_ptr<TrieNode>& trie_node, Path& path,
+void Solver::AddPathByEffect(const Path& path, int score,
+                             const Grid::Mask& removed, PathsByEffect& paths) {
+  auto [it, inserted] =
+      paths.try_emplace(std::make_pair(score, removed), path, 1);
+  if (inserted) return;
+  auto& [representative, count] = it->second;
+  ++count;
+  if (path < representative) representative = path;
+}
+
+void Solver::CacheDFS(const std::shared_ptr<TrieNode>& trie_node, Path& path,
+                      const Grid::Footprint& footprint, PathsByEffect& paths) {
+  // Check for failure.
+  if (trie_node == nullptr) return;
+
+  // Check for success.
+  if (trie_node->is_word)
+    AddPathByEffect(
+        path,
+        Grid::ScoreFootprint(footprint, path.size(), path.star_count()),
+        grid_.RemovalMask(footprint, path.size()), paths);
+
+  absl::flat_hash_set<std::shared_ptr<Tile>> options =
+      grid_.PossibleNextTilesForPath(path);
+  for (const std::shared_ptr<Tile>& next : options) {
+    if (absl::Status s = path.push_back(next); !s.ok()) continue;
+    CacheDFS(trie_node->children[next->letter() - 'a'], path,
+             grid_.ExtendFootprint(footprint, next), paths);
+    path.pop_back();
+  }
+}
+
+void Solver::FillGoalDirectedCache(
+    const Path& goal_word,
     absl::btree_map<int, absl::btree_set<Path>, std::greater<int>>& cache) {
+  if (!cache.empty()) return;
+
+  std::vector<int> tiles_to_drop = goal_word.TilesToDrop();
+  if (tiles_to_drop.empty()) return;
+
+  // The targets are the tiles beneath each goal tile that still has to drop.
+  Grid::Mask goal = Grid::MaskOf(goal_word.tiles());
+  Grid::Mask targets;
+  std::vector<std::vector<std::shared_ptr<Tile>>> tiles_beneath =
+      grid_.TilesBeneathEachPathTile(goal_word);
+  for (int i = 0; i < goal_word.size(); ++i)
+    if (tiles_to_drop[i] > 0) targets |= Grid::MaskOf(tiles_beneath[i]);
+  if (targets.none()) return;
+
+  // Any word that passes through a goal tile, or through a rare tile sharing a
+  // row with one, would remove that goal tile. There's no need to explore them.
+  Grid::Mask forbidden = goal;
+  std::vector<bool> goal_rows(Grid::kNumRows, false);
+  for (const std::shared_ptr<Tile>& tile : goal_word.tiles())
+    goal_rows[tile->row()] = true;
+  for (const std::vector<std::shared_ptr<Tile>>& column : grid_.tiles())
+    for (const std::shared_ptr<Tile>& tile : column)
+      if (tile != nullptr && tile->is_rare() && goal_rows[tile->row()])
+        forbidden.set(Grid::MaskIndex(tile->coords()));
+
+  PathsByEffect paths;
+  Path path;
+  for (const std::vector<std::shared_ptr<Tile>>& column : grid_.tiles()) {
+    for (const std::shared_ptr<Tile>& tile : column) {
+      if (tile == nullptr || forbidden.test(Grid::MaskIndex(tile->coords())))
+        continue;
+      if (absl::Status s = path.push_back(tile); !s.ok()) continue;
+      GoalDirectedDFS(dict_.trie().root()->children[tile->letter() - 'a'],
+                      path, grid_.ExtendFootprint({}, tile), goal, targets,
+                      forbidden, paths);
+      path.pop_back();
+    }
+  }
+
+  for (const auto& [effect, representative] : paths)
+    cache[(effect.second & targets).count()].insert(representative.first);
+}
+
+void Solver::GoalDirectedDFS(
+    const std::shared_ptr<TrieNode>& trie_node, Path& path,
+    const Grid::Footprint& footprint, const Grid::Mask& goal,
+    const Grid::Mask& targets,
+    const Grid::Mask& forbidden, PathsByEffect& paths) {
   // Check for failure.
   if (trie_node == nullptr) return;
 
   // Check for success.
-  if (trie_node->is_word) cache[grid_.ScorePath(path)].insert(path);
+  if (trie_node->is_word) {
+    Grid::Mask removed = grid_.RemovalMask(footprint, path.size());
+    if ((removed & goal).none() && (removed & targets).any())
+      AddPathByEffect(
+          path,
+          Grid::ScoreFootprint(footprint, path.size(), path.star_count()),
+          removed, paths);
+  }
 
   absl::flat_hash_set<std::shared_ptr<Tile>> options =
       grid_.PossibleNextTilesForPath(path);
   for (const std::shared_ptr<Tile>& next : options) {
+    if (forbidden.test(Grid::MaskIndex(next->coords()))) continue;
     if (absl::Status s = path.push_back(next); !s.ok()) continue;
-    CacheDFS(trie_node->children[next->letter() - 'a'], path, cache);
+    GoalDirectedDFS(trie_node->children[next->letter() - 'a'], path,
+                    grid_.ExtendFootprint(footprint, next), goal, targets,
+                    forbidden, paths);
     path.pop_back();
   }
 }
@@ -431,25 +625,14 @@ absl::StatusOr<std::vector<Path>> Solver::StepsToPlayGoalWordDFS(
   if (!goal_word.IsStillPossible())
     return absl::OutOfRangeError(kGoalPathNotPossible);
 
-  // Get all options by calling CacheDFS. We store them locally rather than
-  // using `word_cache_` because backtracking would continually clear it.
+  // Get only the options that move the goal path closer to continuity. We
+  // store them locally rather than using `word_cache_` because backtracking
+  // would continually clear it.
   absl::btree_map<int, absl::btree_set<Path>, std::greater<int>> cache;
-  FillWordCache(cache);
+  FillGoalDirectedCache(goal_word, cache);
   for (const auto& [_, paths] : cache) {
     for (const Path& path : paths) {
-      std::vector<std::shared_ptr<Tile>> affected_tiles =
-          grid_.TilesRemovedBy(path);
-      bool interferes_with_goal_path = false;
-      for (const std::shared_ptr<Tile>& tile : goal_word.tiles()) {
-        if (absl::c_contains(affected_tiles, tile)) {
-          interferes_with_goal_path = true;
-          break;
-        }
-      }
-      if (interferes_with_goal_path) continue;
-
-      // For each viable option, use it, recurse, then backtrack if
-      // unsuccessful.
+      // For each option, use it, recurse, then backtrack if unsuccessful.
       if (absl::Status s = PlayWord(path); !s.ok()) continue;
       if (absl::StatusOr<std::vector<Path>> s =
               StepsToPlayGoalWordDFS(goal_word);
@@ -464,6 +647,26 @@ absl::StatusOr<std::vector<Path>> Solver::StepsToPlayGoalWordDFS(
       absl::StrFormat(kWordNotInGridError, goal_word.word()));
 }
 
+int Solver::EndgameDFS(absl::flat_hash_map<std::string, int>& memo) {
+  std::string key = absl::StrFormat("%v", grid_);
+  if (auto it = memo.find(key); it != memo.end()) return it->second;
+
+  // Word scores are always positive and clearing tiles never costs a bonus, so
+  // stopping early is never better--but it's a safe floor.
+  int best = grid_.ScoreBonuses();
+  absl::btree_map<int, absl::btree_set<Path>, std::greater<int>> cache;
+  FillWordCache(cache);
+  for (const auto& [score, paths] : cache) {
+    for (const Path& path : paths) {
+      if (absl::Status s = grid_.ClearPath(path); !s.ok()) continue;
+      best = std::max(best, score + EndgameDFS(memo));
+      (void)grid_.RevertLastClear();
+    }
+  }
+  memo[key] = best;
+  return best;
+}
+
 absl::Status Solver::PlayGoalWord(const Path& goal_word) {
   absl::StatusOr<std::vector<Path>> steps = StepsToPlayGoalWordDFS(goal_word);
   if (!steps.ok()) return steps.status();
@@ -14,6 +14,7 @@
 
 #include "absl/container/btree_map.h"
 #include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "dict.h"
@@ -35,13 +36,19 @@ class Solver {
   // The simplest constructor for a `Solver`, taking a `Dict` and a `Grid`. For
   // simplicity, the grid can be provided in the form of `grid_strings`.
   Solver(const Dict& dict, const Grid& grid)
-      : dict_(dict), grid_(grid), word_score_sum_(0) {}
+      : dict_(dict),
+        grid_(grid),
+        word_score_sum_(0),
+        endgame_threshold_(kDefaultEndgameThreshold) {}
   Solver(const Dict& dict, const std::vector<std::string>& grid_strings)
       : Solver(dict, Grid(grid_strings)) {}
 
   // The dict can also be created from a trie, although this is less efficient.
   Solver(const Trie& trie, const Grid& grid)
-      : dict_(trie), grid_(grid), word_score_sum_(0) {}
+      : dict_(trie),
+        grid_(grid),
+        word_score_sum_(0),
+        endgame_threshold_(kDefaultEndgameThreshold) {}
   Solver(const Trie& trie, const std::vector<std::string>& grid_strings)
       : Solver(trie, Grid(grid_strings)) {}
 
@@ -80,11 +87,22 @@ class Solver {
   // Solver::word_cache()
   //
   // Returns a data structure containing all the words currently on `grid_`.
+  // Paths that would remove exactly the same tiles for the same score are
+  // interchangeable, so only one representative of each is kept.
   absl::btree_map<int, absl::btree_set<Path>, std::greater<int>> word_cache()
       const {
     return word_cache_;
   }
 
+  // Solver::multiplicity()
+  //
+  // Returns the number of paths on `grid_` that `path` represents in
+  // `word_cache_`, or 0 if `path` is not in the cache.
+  int multiplicity(const Path& path) const {
+    auto it = word_multiplicities_.find(path);
+    return it == word_multiplicities_.end() ? 0 : it->second;
+  }
+
   // Solver::solution()
   //
   // Provides access to the solution thus far, which is the vector of `Path`
@@ -116,9 +134,22 @@ class Solver {
   // Returns `true` if `grid_` no longer has tiles in it.
   bool FullClear() const { return grid_.FullClear(); }
 
+  // Solver::endgame_threshold()
+  //
+  // Returns the number of tiles at or below which the solution methods hand
+  // off to `SolveEndgame()`.
+  int endgame_threshold() const { return endgame_threshold_; }
+
   //----------
   // Mutators
 
+  // Solver::set_endgame_threshold()
+  //
+  // Sets the number of tiles at or below which the solution methods hand off
+  // to `SolveEndgame()`. A threshold of 0 only hands off once the grid is
+  // already clear, effectively disabling it.
+  void set_endgame_threshold(int threshold) { endgame_threshold_ = threshold; }
+
   // Solver::reset()
   //
   // Returns the solver to its starting state.
@@ -148,7 +179,8 @@ class Solver {
   // Solver::SolveGreedily()
   //
   // Repeatedly plays the highest-scoring word available until no more words can
-  // be found.
+  // be found. Once `grid_` is down to `endgame_threshold_` tiles, hands off to
+  // `SolveEndgame()`.
   absl::Status SolveGreedily();
 
   // Solver::SolveWithOneLongWord()
@@ -157,6 +189,14 @@ class Solver {
   // high-multiplier word. After playing the long word, solves greedily.
   absl::Status SolveWithOneLongWord();
 
+  // Solver::SolveEndgame()
+  //
+  // Plays the sequence of words that maximizes the final score, including the
+  // bonuses for `AlmostThere()` and `FullClear()`. Every sequence is searched,
+  // with the best result from each grid layout memoized, so this is only cheap
+  // on the small boards left near the end of a game.
+  absl::Status SolveEndgame();
+
   //----------
   // Helpers
 
@@ -175,6 +215,22 @@ class Solver {
   // words that use all 3 stars, then 20, down until we finish length-17 (x68)
   absl::StatusOr<std::vector<Path>> BestPossibleGoalWord();
 
+  // Solver::GoalWordCandidates()
+  //
+  // Walks the trie against a relaxed model of `grid_` in which only columns
+  // matter: each letter must come from the same column as the previous letter
+  // or a neighboring one, and no column can supply more of a letter than its
+  // `LetterCount` holds. Star tiles are tracked individually, so the column
+  // gaps between them are respected as well.
+  //
+  // Returns every word that could be laid across the columns using at least
+  // two stars, keyed by the highest multiplier it could earn. Words that pass
+  // this test are not guaranteed to have a path, but words that fail it
+  // definitely do not.
+  absl::btree_map<int, absl::btree_set<std::string, Dict::LongerStrComp>,
+                  std::greater<int>>
+  GoalWordCandidates() const;
+
   // A TEMPORARY method that calls `StepsToPlayGoalWordDFS()`. Will be removed
   // once `SolveWithOneLongWord()` is assembled.
   absl::Status PlayGoalWord(const Path& goal_word);
@@ -207,8 +263,28 @@ class Solver {
   // If `cache` is empty, runs DFS on the grid and populates `cache` with the
   // results. Does not run if `cache` is populated. If called without a
   // parameter, fills `word_cache_`.
-  void FillWordCache() { FillWordCache(word_cache_); };
+  //
+  // Paths that remove the same tiles for the same score are collapsed into a
+  // single representative. If `multiplicities` is provided, it is populated
+  // with the number of paths each representative stands for.
+  void FillWordCache() { FillWordCache(word_cache_, &word_multiplicities_); };
   void FillWordCache(
+      absl::btree_map<int, absl::btree_set<Path>, std::greater<int>>& cache,
+      absl::flat_hash_map<Path, int>* multiplicities = nullptr);
+
+  // Solver::FillGoalDirectedCache()
+  //
+  // Populates `cache` with only the words that can help `goal_word` become
+  // continuous. Every word in `cache` removes at least one of the tiles beneath
+  // a goal tile that still needs to drop (as determined by
+  // `Path::TilesToDrop()`), and none of them removes a tile of `goal_word`.
+  // Words are keyed by how many of those in-the-way tiles they remove, so the
+  // most useful moves are tried first. As in `FillWordCache()`, paths with
+  // identical effects are collapsed into one.
+  //
+  // Does not run if `cache` is populated.
+  void FillGoalDirectedCache(
+      const Path& goal_word,
       absl::btree_map<int, absl::btree_set<Path>, std::greater<int>>& cache);
 
  private:
@@ -246,14 +322,53 @@ class Solver {
       absl::string_view word, int i, LetterCount& unused_star_letters,
       Path& path);
 
+  // Solver::PathsByEffect
+  //
+  // The paths found by a DFS, keyed by their score and the `Grid::Mask` of the
+  // tiles they remove. Each key holds a representative path and the number of
+  // paths found with that effect.
+  using PathsByEffect =
+      absl::flat_hash_map<std::pair<int, Grid::Mask>, std::pair<Path, int>>;
+
+  // Solver::AddPathByEffect()
+  //
+  // Counts `path` under its effect in `paths`. The least path (by
+  // `operator<`) with a given effect is kept as its representative, so the
+  // choice does not depend on the order in which paths are found.
+  static void AddPathByEffect(const Path& path, int score,
+                              const Grid::Mask& removed, PathsByEffect& paths);
+
+  // Solver::GoalWordCandidatesDFS()
+  //
+  // A recursive helper method called by `GoalWordCandidates()`. `supply` holds
+  // the count of each non-star letter in each column, and bit `i` of
+  // `stars_used` is set if `stars[i]` is already part of `word`.
+  void GoalWordCandidatesDFS(
+      const std::shared_ptr<TrieNode>& trie_node, int col, int stars_used,
+      const std::vector<std::shared_ptr<Tile>>& stars,
+      std::vector<std::vector<int>>& supply, std::string& word,
+      absl::flat_hash_map<std::string, int>& multipliers) const;
+
   // Solver::CacheDFS()
   //
   // A recursive helper method called by `FillWordCache()`. In parallel,
   // searches `trie_` and `grid_` depth-first from the node and the last tile in
-  // `path`.
-  void CacheDFS(
+  // `path`. `footprint` is the `Grid::Footprint` of `path`, which is extended
+  // along with it so that each word is scored without rescanning the path.
+  void CacheDFS(const std::shared_ptr<TrieNode>& trie_node, Path& path,
+                const Grid::Footprint& footprint, PathsByEffect& paths);
+
+  // Solver::GoalDirectedDFS()
+  //
+  // A recursive helper method called by `FillGoalDirectedCache()`. Works like
+  // `CacheDFS()`, but never steps onto a tile in `forbidden`, and only adds a
+  // word to `cache` if the tiles it removes avoid `goal` and intersect
+  // `targets`.
+  void GoalDirectedDFS(
       const std::shared_ptr<TrieNode>& trie_node, Path& path,
-      absl::btree_map<int, absl::btree_set<Path>, std::greater<int>>& cache);
+      const Grid::Footprint& footprint, const Grid::Mask& goal,
+      const Grid::Mask& targets,
+      const Grid::Mask& forbidden, PathsByEffect& paths);
 
   // Solver::StepsToPlayGoalWordDFS()
   //
@@ -267,12 +382,24 @@ class Solver {
   absl::StatusOr<std::vector<Path>> StepsToPlayGoalWordDFS(
       const Path& goal_word);
 
+  // Solver::EndgameDFS()
+  //
+  // A recursive helper method called by `SolveEndgame()`. Returns the most
+  // points that can still be earned from `grid_`, counting both words and
+  // bonuses. Results are stored in `memo`, keyed by the string form of the
+  // grid.
+  int EndgameDFS(absl::flat_hash_map<std::string, int>& memo);
+
   const Dict dict_;
   Grid grid_;
   absl::btree_map<int, absl::btree_set<Path>, std::greater<int>> word_cache_;
+  absl::flat_hash_map<Path, int> word_multiplicities_;
   std::vector<Path> solution_;
   std::vector<std::string> snapshots_;
   int word_score_sum_;
+  int endgame_threshold_;
+
+  static constexpr int kDefaultEndgameThreshold = 16;
 
   //------------------
   // Abseil functions
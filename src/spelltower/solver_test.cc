@@ -20,6 +20,45 @@ TEST(SolverTest, WordCache) {
   solver.FillWordCache();
   EXPECT_THAT(solver.word_cache(), testing::SizeIs(3));
   EXPECT_THAT(solver.word_cache().begin()->second, testing::SizeIs(1));
+
+  // "arb", "bar", and "bra" all remove the same tiles for the same score, so
+  // only one of them is kept, standing in for all three.
+  auto lowest_scoring = solver.word_cache().rbegin()->second;
+  ASSERT_THAT(lowest_scoring, testing::SizeIs(2));
+  std::vector<int> multiplicities;
+  for (const Path& path : lowest_scoring)
+    multiplicities.push_back(solver.multiplicity(path));
+  EXPECT_THAT(multiplicities, testing::UnorderedElementsAre(1, 3));
+}
+
+TEST(SolverTest, GoalWordCandidates) {
+  // Only "abc" can be laid across adjacent columns using both stars. The c in
+  // "cab" is two columns away from the a.
+  Solver solver(Trie({"ab", "abc", "cab", "bcb"}), Grid({"..b", "AbC"}));
+  auto candidates = solver.GoalWordCandidates();
+  ASSERT_THAT(candidates, testing::SizeIs(1));
+  EXPECT_EQ(candidates.begin()->first, 9);
+  EXPECT_THAT(candidates.begin()->second, testing::ElementsAre("abc"));
+}
+
+TEST(SolverTest, GoalDirectedCache) {
+  // "at" can only be played once the a drops into row 1.
+  Solver solver(Trie({"at", "no", "of", "to"}), Grid({"a..", "nof", "ete"}));
+  Path at;
+  ASSERT_THAT(at.push_back({solver.TileAt(2, 0), solver.TileAt(0, 1)}),
+              IsOk());
+  Path no;
+  ASSERT_THAT(no.push_back({solver.TileAt(1, 0), solver.TileAt(1, 1)}),
+              IsOk());
+
+  // "of" removes nothing beneath the a, and "to" would remove the t itself.
+  absl::btree_map<int, absl::btree_set<Path>, std::greater<int>> cache;
+  solver.FillGoalDirectedCache(at, cache);
+  ASSERT_THAT(cache, testing::SizeIs(1));
+  EXPECT_THAT(cache.begin()->second, testing::ElementsAre(no));
+
+  EXPECT_THAT(solver.PlayGoalWord(at), IsOk());
+  EXPECT_THAT(solver.solution(), testing::ElementsAre(no, at));
 }
 
 // TEST(SolverTest, BestPossibleThreeStarPathForWord) {
@@ -254,6 +293,31 @@ TEST(SolverTest, PlayGoalWordFails) {
 
 TEST(SolverTest, SolveGreedily) {}
 
+TEST(SolverTest, SolveEndgame) {
+  Trie trie({"cat", "act", "tab", "bat", "at", "ta", "tact", "cab"});
+
+  // Played greedily, "cab" scores best but leaves three tiles in a column.
+  Solver greedy(trie, Grid({"bca", "tbb", "bbc"}));
+  greedy.set_endgame_threshold(0);
+  ASSERT_THAT(greedy.SolveGreedily(), IsOk());
+  EXPECT_FALSE(greedy.AlmostThere());
+  EXPECT_EQ(greedy.score(), 27);
+
+  // Searched exhaustively, "act" scores less but earns the bonus.
+  Solver exact(trie, Grid({"bca", "tbb", "bbc"}));
+  ASSERT_THAT(exact.SolveGreedily(), IsOk());
+  EXPECT_TRUE(exact.AlmostThere());
+  EXPECT_EQ(exact.score(), 1021);
+  ASSERT_THAT(exact.solution(), testing::SizeIs(1));
+  EXPECT_EQ(exact.solution()[0].word(), "act");
+
+  // Retracing a line of play that takes more than one word.
+  Solver two_words(trie, Grid({"cat", "tab"}));
+  ASSERT_THAT(two_words.SolveGreedily(), IsOk());
+  EXPECT_EQ(two_words.grid().NumTiles(), 0);
+  EXPECT_THAT(two_words.solution(), testing::SizeIs(2));
+}
+
 TEST(SolverTest, AbslStringify) {
   Trie trie({"carb", "crab", "arb", "arc", "bar", "bra", "cab", "car", "scat"});
   // sca
@@ -0,0 +1,114 @@
+#include "board.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+
+namespace puzzmo::typeshift {
+namespace {
+
+constexpr absl::string_view kNoColumnsError =
+    "A Typeshift board needs at least one column.";
+constexpr absl::string_view kEmptyColumnError =
+    "Every column of a Typeshift board needs at least one letter.";
+constexpr absl::string_view kBadLetterError =
+    "Typeshift boards can only hold lowercase letters.";
+constexpr absl::string_view kTooManyLettersError =
+    "Typeshift boards can hold at most 64 letters.";
+
+}  // namespace
+
+absl::StatusOr<Board> Board::Create(const std::vector<std::string> &columns) {
+  if (columns.empty()) return absl::InvalidArgumentError(kNoColumnsError);
+  Board board;
+  for (const std::string &column : columns) {
+    std::string letters;
+    for (const char c : column) {
+      if (std::isspace(static_cast<unsigned char>(c))) continue;
+      if (c < 'a' || c > 'z')
+        return absl::InvalidArgumentError(kBadLetterError);
+      letters.push_back(c);
+    }
+    std::sort(letters.begin(), letters.end());
+    letters.erase(std::unique(letters.begin(), letters.end()), letters.end());
+    if (letters.empty()) return absl::InvalidArgumentError(kEmptyColumnError);
+    if (board.num_letters_ + letters.size() > kMaxLetters)
+      return absl::InvalidArgumentError(kTooManyLettersError);
+
+    std::array<int8_t, 26> bits;
+    bits.fill(-1);
+    uint64_t mask = 0;
+    for (const char c : letters) {
+      bits[c - 'a'] = board.num_letters_;
+      mask |= uint64_t{1} << board.num_letters_++;
+    }
+    board.bits_.push_back(bits);
+    board.columns_.push_back(mask);
+  }
+  return board;
+}
+
+uint64_t Board::Mask(absl::string_view word) const {
+  if (word.size() != bits_.size()) return 0;
+  uint64_t mask = 0;
+  for (int i = 0; i < word.size(); ++i) {
+    if (word[i] < 'a' || word[i] > 'z') return 0;
+    const int bit = bits_[i][word[i] - 'a'];
+    if (bit < 0) return 0;
+    mask |= uint64_t{1} << bit;
+  }
+  return mask;
+}
+
+std::string Board::ToString() const {
+  std::vector<std::string> columns;
+  for (const std::array<int8_t, 26> &bits : bits_) {
+    std::string column;
+    for (int i = 0; i < bits.size(); ++i) {
+      if (bits[i] >= 0) column.push_back('a' + i);
+    }
+    columns.push_back(column);
+  }
+  return absl::StrJoin(columns, " ");
+}
+
+absl::StatusOr<std::vector<Board>> ReadBoardsFromFile(absl::string_view path) {
+  std::ifstream file{std::string(path)};
+  if (!file.is_open()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Error: Could not open ", path));
+  }
+  std::vector<Board> boards;
+  std::vector<std::string> columns;
+  std::string line;
+  while (true) {
+    const bool more = static_cast<bool>(std::getline(file, line));
+    const bool blank = std::all_of(line.begin(), line.end(), [](char c) {
+      return std::isspace(static_cast<unsigned char>(c));
+    });
+    if (more && !blank) {
+      columns.push_back(line);
+      continue;
+    }
+    if (!columns.empty()) {
+      absl::StatusOr<Board> board = Board::Create(columns);
+      if (!board.ok()) return board.status();
+      boards.push_back(*std::move(board));
+      columns.clear();
+    }
+    if (!more) break;
+  }
+  file.close();
+  return boards;
+}
+
+}  // namespace puzzmo::typeshift
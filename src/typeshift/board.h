@@ -0,0 +1,87 @@
+// -----------------------------------------------------------------------------
+// File: board.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines boards. A Typeshift board is a row of columns, each
+// holding a few letters, and a word is spelled by taking one letter from each
+// column in order.
+
+#ifndef PUZZMO_TYPESHIFT_BOARD_H_
+#define PUZZMO_TYPESHIFT_BOARD_H_
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace puzzmo::typeshift {
+
+// typeshift::Board
+//
+// The `Board` class holds the letters in each column of a Typeshift board.
+// Each letter is numbered by one bit of a 64-bit mask, column by column and in
+// alphabetical order within a column, so that any set of letters on the board
+// is a mask. This is the form `CoverSolver` works in.
+class Board {
+ public:
+  static constexpr int kMaxLetters = 64;
+
+  // Board::Create()
+  //
+  // Creates a board from one string per column, holding that column's
+  // letters. Whitespace is ignored, as are repeats of a letter in a column.
+  //
+  // Fails if there are no columns, if a column is empty, if a letter is not
+  // lowercase, or if there are more than `kMaxLetters` letters.
+  static absl::StatusOr<Board> Create(const std::vector<std::string> &columns);
+
+  // Board::num_columns()
+  //
+  // The length of every word on the board.
+  int num_columns() const { return columns_.size(); }
+
+  // Board::num_letters()
+  //
+  // The number of letters on the board, across all columns.
+  int num_letters() const { return num_letters_; }
+
+  // Board::columns()
+  //
+  // The mask of the letters in each column.
+  const std::vector<uint64_t> &columns() const { return columns_; }
+
+  // Board::Mask()
+  //
+  // Returns the mask of the letters that `word` uses, or 0 if it cannot be
+  // spelled on the board.
+  uint64_t Mask(absl::string_view word) const;
+
+  // Board::ToString()
+  //
+  // Returns the letters of each column, with the columns separated by spaces.
+  std::string ToString() const;
+
+ private:
+  Board() = default;
+
+  // `bits_[i][c - 'a']` is the bit of letter `c` in column `i`, or -1 if the
+  // column does not hold it.
+  std::vector<std::array<int8_t, 26>> bits_;
+  std::vector<uint64_t> columns_;
+  int num_letters_ = 0;
+};
+
+// typeshift::ReadBoardsFromFile()
+//
+// Reads every board in the file at `path`. Each line of the file holds the
+// letters of one column, and boards are separated by blank lines.
+//
+// Fails if the file cannot be opened or any board is malformed.
+absl::StatusOr<std::vector<Board>> ReadBoardsFromFile(absl::string_view path);
+
+}  // namespace puzzmo::typeshift
+
+#endif
@@ -0,0 +1,63 @@
+#include "board.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace puzzmo::typeshift {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::SizeIs;
+
+TEST(BoardTest, Create) {
+  absl::StatusOr<Board> board = Board::Create({"tc", "a o", "ttb"});
+  ASSERT_THAT(board, IsOk());
+  EXPECT_EQ(board->num_columns(), 3);
+  EXPECT_EQ(board->num_letters(), 6);
+  EXPECT_THAT(board->columns(), ElementsAre(0b11, 0b1100, 0b110000));
+  EXPECT_EQ(board->ToString(), "ct ao bt");
+}
+
+TEST(BoardTest, CreateRejectsBadColumns) {
+  EXPECT_THAT(Board::Create({}), StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(Board::Create({"ab", " "}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(Board::Create({"ab", "C"}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  const std::vector<std::string> too_many_letters(3, "abcdefghijklmnopqrstuv");
+  EXPECT_THAT(Board::Create(too_many_letters),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(BoardTest, Mask) {
+  absl::StatusOr<Board> board = Board::Create({"ct", "ao", "bt"});
+  ASSERT_THAT(board, IsOk());
+  EXPECT_EQ(board->Mask("cat"), 0b100101);
+  EXPECT_EQ(board->Mask("tob"), 0b011010);
+  EXPECT_EQ(board->Mask("cut"), 0);
+  EXPECT_EQ(board->Mask("cats"), 0);
+}
+
+TEST(BoardTest, ReadBoardsFromFile) {
+  const std::string path = testing::TempDir() + "board_test_boards.txt";
+  std::ofstream(path) << "ct\nao\nbt\n\n\nabc\nde\n";
+  absl::StatusOr<std::vector<Board>> boards = ReadBoardsFromFile(path);
+  ASSERT_THAT(boards, IsOk());
+  ASSERT_THAT(*boards, SizeIs(2));
+  EXPECT_EQ((*boards)[0].ToString(), "ct ao bt");
+  EXPECT_EQ((*boards)[1].ToString(), "abc de");
+
+  EXPECT_THAT(ReadBoardsFromFile(testing::TempDir() + "no_such_file.txt"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace puzzmo::typeshift
@@ -0,0 +1,151 @@
+#include "cover_solver.h"
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace puzzmo::typeshift {
+namespace {
+
+constexpr absl::string_view kUncoverableLetterError =
+    "Some letter on the board is not used by any word.";
+constexpr absl::string_view kBadKnownCoverError =
+    "The known cover does not use every letter on the board.";
+
+// How many branches to explore between looks at the clock.
+constexpr int kClockInterval = 1024;
+
+}  // namespace
+
+std::vector<int> GreedyCover(const std::vector<uint64_t> &words,
+                             uint64_t board) {
+  std::vector<int> cover;
+  for (uint64_t uncovered = board; uncovered != 0;) {
+    int best_word = -1;
+    int best_gain = 0;
+    for (int i = 0; i < words.size(); ++i) {
+      const int gain = std::popcount(words[i] & uncovered);
+      if (gain > best_gain) {
+        best_gain = gain;
+        best_word = i;
+      }
+    }
+    if (best_word < 0) return {};
+    cover.push_back(best_word);
+    uncovered &= ~words[best_word];
+  }
+  return cover;
+}
+
+absl::StatusOr<Cover> CoverSolver::Solve(const std::vector<int> &known_cover) {
+  uint64_t board = 0;
+  for (uint64_t column : columns_) board |= column;
+  uint64_t coverable = 0;
+  for (uint64_t &word : words_) {
+    word &= board;
+    coverable |= word;
+  }
+  if (coverable != board)
+    return absl::NotFoundError(kUncoverableLetterError);
+
+  // A candidate whose letters another candidate also uses can be swapped for
+  // it in any cover, so it need never be tried.
+  std::vector<int> useful;
+  for (int i = 0; i < words_.size(); ++i) {
+    bool dominated = false;
+    for (int j = 0; j < words_.size() && !dominated; ++j) {
+      dominated = j != i && (words_[i] & ~words_[j]) == 0 &&
+                  (words_[i] != words_[j] || j < i);
+    }
+    if (!dominated) useful.push_back(i);
+  }
+  std::stable_sort(useful.begin(), useful.end(), [this](int a, int b) {
+    return std::popcount(words_[a]) > std::popcount(words_[b]);
+  });
+  candidates_.assign(64, {});
+  for (int word : useful) {
+    for (uint64_t left = words_[word]; left != 0; left &= left - 1)
+      candidates_[std::countr_zero(left)].push_back(word);
+  }
+  excluded_.assign(words_.size(), false);
+
+  if (known_cover.empty()) {
+    best_ = GreedyCover(words_, board);
+  } else {
+    uint64_t covered = 0;
+    for (int word : known_cover) {
+      if (word < 0 || word >= words_.size())
+        return absl::InvalidArgumentError(kBadKnownCoverError);
+      covered |= words_[word];
+    }
+    if (covered != board)
+      return absl::InvalidArgumentError(kBadKnownCoverError);
+    best_ = known_cover;
+  }
+
+  nodes_ = 0;
+  deadline_ = absl::Now() + params_.time_limit;
+  std::vector<int> chosen;
+  const bool optimal = Search(board, chosen);
+  std::vector<int> words = best_;
+  std::sort(words.begin(), words.end());
+  return Cover{.words = words, .optimal = optimal};
+}
+
+bool CoverSolver::Search(uint64_t uncovered, std::vector<int> &chosen) {
+  if (++nodes_ % kClockInterval == 0 && absl::Now() >= deadline_)
+    return false;
+  if (uncovered == 0) {
+    best_ = chosen;
+    return true;
+  }
+  if (chosen.size() + LowerBound(uncovered) >= best_.size()) return true;
+
+  // Branch on the letter that the fewest candidates left can use.
+  int branch_bit = -1;
+  int fewest = INT_MAX;
+  for (uint64_t left = uncovered; left != 0; left &= left - 1) {
+    const int bit = std::countr_zero(left);
+    int count = 0;
+    for (int word : candidates_[bit]) count += !excluded_[word];
+    if (count == 0) return true;
+    if (count < fewest) {
+      fewest = count;
+      branch_bit = bit;
+    }
+  }
+
+  // Every cover uses some candidate for the letter. Once the branch for one
+  // has been searched, the branches after it need not use it again.
+  std::vector<int> tried;
+  bool finished = true;
+  for (int word : candidates_[branch_bit]) {
+    if (excluded_[word]) continue;
+    chosen.push_back(word);
+    finished = Search(uncovered & ~words_[word], chosen);
+    chosen.pop_back();
+    if (!finished) break;
+    excluded_[word] = true;
+    tried.push_back(word);
+    if (chosen.size() + LowerBound(uncovered) >= best_.size()) break;
+  }
+  for (int word : tried) excluded_[word] = false;
+  return finished;
+}
+
+int CoverSolver::LowerBound(uint64_t uncovered) const {
+  int bound = 0;
+  for (uint64_t column : columns_)
+    bound = std::max(bound, std::popcount(uncovered & column));
+  return bound;
+}
+
+}  // namespace puzzmo::typeshift
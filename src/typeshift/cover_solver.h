@@ -0,0 +1,119 @@
+// -----------------------------------------------------------------------------
+// File: cover_solver.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines a solver for the set-cover problem at the heart of
+// Typeshift: choosing the fewest words that between them use every letter on
+// the board.
+
+#ifndef PUZZMO_TYPESHIFT_COVER_SOLVER_H_
+#define PUZZMO_TYPESHIFT_COVER_SOLVER_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+
+namespace puzzmo::typeshift {
+
+// typeshift::Cover
+//
+// A set of words, as indices into the candidates given to `CoverSolver`, that
+// between them use every letter on the board. If `optimal` is true, no smaller
+// set does.
+struct Cover {
+  std::vector<int> words;
+  bool optimal;
+};
+
+// typeshift::GreedyCover()
+//
+// Returns a cover of `board` built by repeatedly taking the candidate in
+// `words` that uses the most letters not yet covered, ties going to the
+// earliest. A candidate's gain is the popcount of its mask over the letters
+// still uncovered. Returns an empty vector if some letter is used by no
+// candidate.
+std::vector<int> GreedyCover(const std::vector<uint64_t> &words,
+                             uint64_t board);
+
+// typeshift::CoverSolver
+//
+// Finds a minimum cover of a board's letters by branch and bound. Each letter
+// in each column of the board is one bit of a 64-bit mask, and each candidate
+// word is the mask of the letters it uses, one per column.
+class CoverSolver {
+ public:
+  // CoverSolver::Parameters
+  //
+  // Options for bounding the search.
+  struct Parameters {
+    // How long to search before settling for the best cover found so far,
+    // which is then not known to be optimal.
+    absl::Duration time_limit = absl::Seconds(1);
+  };
+
+  // `columns` holds the mask of the letters in each column, and `words` the
+  // mask of each candidate word. The columns must not overlap.
+  CoverSolver(std::vector<uint64_t> columns, std::vector<uint64_t> words)
+      : CoverSolver(std::move(columns), std::move(words), Parameters()) {}
+  CoverSolver(std::vector<uint64_t> columns, std::vector<uint64_t> words,
+              Parameters params)
+      : columns_(std::move(columns)),
+        words_(std::move(words)),
+        params_(params) {}
+
+  // CoverSolver::Solve()
+  //
+  // Returns the smallest set of candidates whose masks cover every column. If
+  // `known_cover` is given, only smaller covers are searched for, and it is
+  // returned if there are none. Otherwise the search starts from
+  // `GreedyCover()`.
+  //
+  // The search branches on the letter used by the fewest candidates, trying
+  // each candidate that uses it, and excludes each from the branches after
+  // it. Since a word uses one letter per column, a branch needs at least as
+  // many more words as its fullest column has letters left, which bounds it.
+  //
+  // Returns an error if some letter is used by no candidate, or if
+  // `known_cover` does not cover the board.
+  absl::StatusOr<Cover> Solve(const std::vector<int> &known_cover = {});
+
+  // CoverSolver::nodes()
+  //
+  // The number of branches explored by the last call to `Solve()`.
+  int64_t nodes() const { return nodes_; }
+
+ private:
+  // CoverSolver::Search()
+  //
+  // Looks for a way to extend `chosen` to cover `uncovered` with fewer words
+  // than `best_`, and stores the best one found there. Returns false if the
+  // time limit ran out.
+  bool Search(uint64_t uncovered, std::vector<int> &chosen);
+
+  // CoverSolver::LowerBound()
+  //
+  // Returns how many more words it takes at least to cover `uncovered`.
+  int LowerBound(uint64_t uncovered) const;
+
+  std::vector<uint64_t> columns_;
+  std::vector<uint64_t> words_;
+  const Parameters params_;
+
+  // `candidates_[bit]` holds the candidates that use the letter at `bit`,
+  // most letters first, skipping any whose letters another candidate also
+  // uses. `excluded_` marks those ruled out by an earlier branch. `best_` is
+  // always a cover.
+  std::vector<std::vector<int>> candidates_;
+  std::vector<bool> excluded_;
+
+  std::vector<int> best_;
+  absl::Time deadline_;
+  int64_t nodes_ = 0;
+};
+
+}  // namespace puzzmo::typeshift
+
+#endif
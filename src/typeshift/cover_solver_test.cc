@@ -0,0 +1,112 @@
+#include "cover_solver.h"
+
+#include <bit>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace puzzmo::typeshift {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::StatusIs;
+using ::testing::ElementsAre;
+
+// Two columns of two letters each: bits 0-1 and bits 2-3.
+const std::vector<uint64_t> kColumns = {0b0011, 0b1100};
+
+TEST(GreedyCoverTest, GreedyCover) {
+  // The second word uses three letters, and the third is the first to use the
+  // one left over.
+  EXPECT_THAT(GreedyCover({0b0011, 0b0111, 0b1100, 0b1000}, 0b1111),
+              ElementsAre(1, 2));
+  EXPECT_THAT(GreedyCover({0b0011, 0b0101}, 0b1111), ElementsAre());
+}
+
+TEST(CoverSolverTest, Solve) {
+  CoverSolver solver(kColumns, {0b0101, 0b0110, 0b1001, 0b1010});
+  absl::StatusOr<Cover> cover = solver.Solve();
+  ASSERT_THAT(cover, IsOk());
+  EXPECT_THAT(cover->words, ElementsAre(0, 3));
+  EXPECT_TRUE(cover->optimal);
+}
+
+TEST(CoverSolverTest, SolveKeepsOptimalKnownCover) {
+  // No two words can cover three letters in a column, so the known cover is
+  // already as small as can be.
+  const std::vector<uint64_t> columns = {0b000111, 0b111000};
+  const std::vector<uint64_t> words = {0b001001, 0b010010, 0b100100,
+                                       0b010001, 0b100010, 0b001100};
+  CoverSolver solver(columns, words);
+  absl::StatusOr<Cover> cover = solver.Solve({0, 1, 2});
+  ASSERT_THAT(cover, IsOk());
+  EXPECT_THAT(cover->words, ElementsAre(0, 1, 2));
+  EXPECT_TRUE(cover->optimal);
+
+  EXPECT_THAT(solver.Solve({0, 1}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(solver.Solve({0, 1, 6}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(CoverSolverTest, SolveRejectsUncoverableBoards) {
+  CoverSolver solver(kColumns, {0b0101, 0b0110});
+  EXPECT_THAT(solver.Solve(), StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST(CoverSolverTest, SolveMatchesBruteForce) {
+  std::mt19937 rng(0);
+  for (int trial = 0; trial < 50; ++trial) {
+    // Four columns of three or four letters, and 14 random words.
+    std::vector<uint64_t> columns;
+    std::vector<int> offsets;
+    int bits = 0;
+    for (int i = 0; i < 4; ++i) {
+      const int letters = 3 + rng() % 2;
+      offsets.push_back(bits);
+      columns.push_back(((uint64_t{1} << letters) - 1) << bits);
+      bits += letters;
+    }
+    std::vector<uint64_t> words;
+    for (int w = 0; w < 14; ++w) {
+      uint64_t word = 0;
+      for (int i = 0; i < 4; ++i) {
+        const int letters = std::popcount(columns[i]);
+        word |= uint64_t{1} << (offsets[i] + rng() % letters);
+      }
+      words.push_back(word);
+    }
+
+    int fewest = 0;
+    for (int subset = 0; subset < (1 << words.size()); ++subset) {
+      uint64_t covered = 0;
+      for (int w = 0; w < words.size(); ++w) {
+        if (subset & (1 << w)) covered |= words[w];
+      }
+      if (covered + 1 == uint64_t{1} << bits &&
+          (fewest == 0 || std::popcount(unsigned(subset)) < fewest))
+        fewest = std::popcount(unsigned(subset));
+    }
+
+    CoverSolver solver(columns, words);
+    absl::StatusOr<Cover> cover = solver.Solve();
+    if (fewest == 0) {
+      EXPECT_THAT(cover, StatusIs(absl::StatusCode::kNotFound));
+      continue;
+    }
+    ASSERT_THAT(cover, IsOk());
+    EXPECT_TRUE(cover->optimal);
+    EXPECT_EQ(cover->words.size(), fewest);
+    uint64_t covered = 0;
+    for (int w : cover->words) covered |= words[w];
+    EXPECT_EQ(covered + 1, uint64_t{1} << bits);
+  }
+}
+
+}  // namespace
+}  // namespace puzzmo::typeshift
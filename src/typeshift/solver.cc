@@ -0,0 +1,63 @@
+#include "solver.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "cover_solver.h"
+#include "src/shared/dictionary_utils.h"
+
+namespace puzzmo::typeshift {
+
+Solver::Solver(const std::vector<std::string> &words, Parameters params)
+    : params_(params) {
+  auto words_by_length =
+      std::make_shared<std::vector<std::vector<std::string>>>();
+  for (const std::string &word : words) {
+    if (word.size() >= words_by_length->size())
+      words_by_length->resize(word.size() + 1);
+    (*words_by_length)[word.size()].push_back(word);
+  }
+  for (std::vector<std::string> &same_length : *words_by_length)
+    std::sort(same_length.begin(), same_length.end());
+  words_by_length_ = std::move(words_by_length);
+}
+
+absl::StatusOr<Solver> Solver::CreateSolverWithPuzzmoWords() {
+  return CreateSolverWithPuzzmoWords(Parameters());
+}
+
+absl::StatusOr<Solver> Solver::CreateSolverWithPuzzmoWords(
+    Parameters params) {
+  absl::StatusOr<std::vector<std::string>> words =
+      ReadDictionaryFileToVector({});
+  if (!words.ok()) return words.status();
+  return Solver(*words, params);
+}
+
+absl::StatusOr<Solution> Solver::Solve(const Board &board) const {
+  // A word can be spelled on the board exactly when it has a mask.
+  std::vector<const std::string *> candidates;
+  std::vector<uint64_t> masks;
+  if (board.num_columns() < words_by_length_->size()) {
+    for (const std::string &word : (*words_by_length_)[board.num_columns()]) {
+      const uint64_t mask = board.Mask(word);
+      if (mask == 0) continue;
+      candidates.push_back(&word);
+      masks.push_back(mask);
+    }
+  }
+
+  CoverSolver cover_solver(board.columns(), std::move(masks),
+                           {.time_limit = params_.time_limit});
+  absl::StatusOr<Cover> cover = cover_solver.Solve();
+  if (!cover.ok()) return cover.status();
+  Solution solution = {.optimal = cover->optimal};
+  for (int word : cover->words) solution.words.push_back(*candidates[word]);
+  return solution;
+}
+
+}  // namespace puzzmo::typeshift
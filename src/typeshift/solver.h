@@ -0,0 +1,77 @@
+// -----------------------------------------------------------------------------
+// File: solver.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines the solver class for Typeshift. It holds a
+// dictionary, which is loaded once and can be shared by any number of solvers,
+// and finds the fewest words that use every letter on a board.
+
+#ifndef PUZZMO_TYPESHIFT_SOLVER_H_
+#define PUZZMO_TYPESHIFT_SOLVER_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "board.h"
+
+namespace puzzmo::typeshift {
+
+// typeshift::Solution
+//
+// The words that solve a board, in alphabetical order. If `optimal` is true,
+// no fewer words use every letter.
+struct Solution {
+  std::vector<std::string> words;
+  bool optimal;
+};
+
+// typeshift::Solver
+//
+// The `Solver` class solves Typeshift boards against a fixed dictionary. The
+// dictionary is held by a `std::shared_ptr` to const data, so copies of a
+// solver share one dictionary, and `Solve()` can be called on many boards, or
+// from many threads, without reloading it.
+class Solver {
+ public:
+  // Solver::Parameters
+  //
+  // Options passed through to `CoverSolver`.
+  struct Parameters {
+    // How long to search each board before settling for the best cover found
+    // so far, which is then not known to be optimal.
+    absl::Duration time_limit = absl::Seconds(1);
+  };
+
+  // Creates a solver for the words in `words`. Words may be of any length and
+  // in any order.
+  explicit Solver(const std::vector<std::string> &words)
+      : Solver(words, Parameters()) {}
+  Solver(const std::vector<std::string> &words, Parameters params);
+
+  // Solver::CreateSolverWithPuzzmoWords()
+  //
+  // Creates a solver by reading the Puzzmo dictionary from disk.
+  static absl::StatusOr<Solver> CreateSolverWithPuzzmoWords();
+  static absl::StatusOr<Solver> CreateSolverWithPuzzmoWords(Parameters params);
+
+  // Solver::Solve()
+  //
+  // Returns the fewest dictionary words that between them use every letter on
+  // `board`, as found by `CoverSolver`.
+  //
+  // Fails if some letter on the board is not used by any word.
+  absl::StatusOr<Solution> Solve(const Board &board) const;
+
+ private:
+  // `words_by_length_->at(n)` holds the words of length `n`, sorted.
+  std::shared_ptr<const std::vector<std::vector<std::string>>> words_by_length_;
+  Parameters params_;
+};
+
+}  // namespace puzzmo::typeshift
+
+#endif
@@ -0,0 +1,54 @@
+#include "solver.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace puzzmo::typeshift {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::StatusIs;
+using ::testing::ElementsAre;
+
+const std::vector<std::string> kWords = {"bat", "cab", "cat", "cot",
+                                         "tab", "tat", "to",  "tot"};
+
+TEST(SolverTest, Solve) {
+  Solver solver(kWords);
+  absl::StatusOr<Board> board = Board::Create({"ct", "ao", "bt"});
+  ASSERT_THAT(board, IsOk());
+  absl::StatusOr<Solution> solution = solver.Solve(*board);
+  ASSERT_THAT(solution, IsOk());
+  EXPECT_THAT(solution->words, ElementsAre("cab", "tot"));
+  EXPECT_TRUE(solution->optimal);
+}
+
+TEST(SolverTest, SolveRejectsUnusableLetters) {
+  Solver solver(kWords);
+  absl::StatusOr<Board> board = Board::Create({"ctz", "ao", "bt"});
+  ASSERT_THAT(board, IsOk());
+  EXPECT_THAT(solver.Solve(*board), StatusIs(absl::StatusCode::kNotFound));
+
+  // No word is this long.
+  board = Board::Create({"c", "a", "t", "s", "s"});
+  ASSERT_THAT(board, IsOk());
+  EXPECT_THAT(solver.Solve(*board), StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST(SolverTest, SolveFromCopy) {
+  Solver solver(kWords);
+  const Solver copy = solver;
+  absl::StatusOr<Board> board = Board::Create({"t", "o"});
+  ASSERT_THAT(board, IsOk());
+  absl::StatusOr<Solution> solution = copy.Solve(*board);
+  ASSERT_THAT(solution, IsOk());
+  EXPECT_THAT(solution->words, ElementsAre("to"));
+}
+
+}  // namespace
+}  // namespace puzzmo::typeshift